@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# Runs the benchmark client against a local Alchemist once for each number of workers given, e.g.
+#   ./bench.sh 1 2 4 -- --rows 1000000 --block-rows 1,1024 --message-kb 1024
+# Everything after "--" is passed on to the client. Build the client and test library first with "make bench" in
+# build/$SYSTEM.
+
+source ./config.sh
+
+export ALCHEMIST_EXE=$ALCHEMIST_PATH/target/alchemist
+export BENCH_EXE=$ALCHEMIST_PATH/target/alchemist-bench
+export TEST_LIBRARY=$ALCHEMIST_PATH/target/libtestlibrary.so
+
+WORKER_COUNTS=()
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	WORKER_COUNTS+=($1)
+	shift
+done
+if [ "$1" = "--" ]; then
+	shift
+fi
+if [ ${#WORKER_COUNTS[@]} -eq 0 ]; then
+	WORKER_COUNTS=(1 2 4)
+fi
+
+for NUM_WORKERS in "${WORKER_COUNTS[@]}"; do
+	mpiexec -n $((NUM_WORKERS+1)) $ALCHEMIST_EXE > $ALCHEMIST_PATH/target/bench_alchemist_$NUM_WORKERS.log 2>&1 &
+	ALCHEMIST_PID=$!
+	sleep 5
+
+	$BENCH_EXE --workers $NUM_WORKERS --library $TEST_LIBRARY "$@"
+
+	kill $ALCHEMIST_PID
+	wait $ALCHEMIST_PID 2> /dev/null
+done
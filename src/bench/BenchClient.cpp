@@ -0,0 +1,467 @@
+#include <chrono>
+#include "../main/Message.hpp"
+
+// Load generator for a local Alchemist: connects to the driver and to the workers it is given, sends a matrix to the
+// workers and reads it back with different block shapes and message sizes, and runs tasks from the test library,
+// reporting throughput and round-trip latencies. See bench.sh for running it against different numbers of workers.
+
+namespace alchemist {
+
+typedef std::chrono::steady_clock bench_clock;
+
+inline double elapsed_ms(const bench_clock::time_point & start)
+{
+	return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+struct BenchOptions {
+	string host = "localhost";
+	uint16_t port = ALCHEMIST_PORT;
+	uint16_t num_workers = 1;
+	uint64_t num_rows = 100000;
+	uint64_t num_cols = 100;
+	vector<uint64_t> block_rows = {1, 64, 1024};
+	vector<uint64_t> block_cols = {0};				// 0 for all columns
+	vector<uint64_t> message_kb = {64, 1024, 16384};
+	uint32_t num_repeats = 3;
+	uint32_t num_tasks = 1000;
+	string library_path = "";
+};
+
+// Blocking connection to the driver or to one of the workers
+class BenchConnection
+{
+public:
+	BenchConnection(io_context & _io_context) : clientID(0), sessionID(0), socket(_io_context), resolver(_io_context) { }
+
+	ClientID clientID;
+	SessionID sessionID;
+
+	bool connect(const string & host, const uint16_t port)
+	{
+		asio::connect(socket, resolver.resolve(host, std::to_string(port)));
+		socket.set_option(tcp::no_delay(true));
+
+		return handshake();
+	}
+
+	Message & start(const client_command command)
+	{
+		out.start(clientID, sessionID, command);
+
+		return out;
+	}
+
+	// Sends the message that was started and waits for the reply
+	Message & exchange()
+	{
+		out.finish();
+		asio::write(socket, asio::buffer(out.header(), out.length()));
+
+		in.clear();
+		asio::read(socket, asio::buffer(in.header(), Message::header_length));
+		in.decode_header();
+		in.reserve(in.body_length);
+		asio::read(socket, asio::buffer(in.body(), in.body_length));
+
+		return in;
+	}
+
+private:
+	tcp::socket socket;
+	tcp::resolver resolver;
+
+	Message in, out;
+
+	bool handshake()
+	{
+		in.set_client_language(CPP);
+		out.set_client_language(CPP);
+
+		Message & msg = start(HANDSHAKE);
+		msg.write_uint8(CPP);
+		msg.write_uint16(1234);
+		msg.write_string(string("ABCD"));
+		msg.write_double(1.11);
+		msg.write_double(2.22);
+
+		DoubleArrayBlock_ptr block = std::make_shared<ArrayBlock<double>>(2);
+		uint64_t dims[3][2] = {{0, 0}, {3, 4}, {1, 1}};
+		for (int j = 0; j < 3; j++)
+			for (int i = 0; i < 2; i++) block->dims[j][i] = dims[j][i];
+		block->size = 12;
+
+		msg.write_DoubleArrayBlock(block);
+		for (uint64_t i = 0; i < block->size; i++) {
+			double x = 1.11*(i+3);
+			memcpy(block->start + 8*i, &x, 8);
+		}
+		msg.finish_DoubleArrayBlock(block);
+
+		// Rows are assigned to workers by the worker of each row, so the full layout is needed
+		msg.write_uint8(OPTION_ROW_LAYOUT);
+
+		Message & reply = exchange();
+		if (reply.cc != HANDSHAKE || reply.ec != ERR_NONE) return false;
+
+		clientID = reply.clientID;
+		sessionID = reply.sessionID;
+
+		reply.read_uint16();
+		reply.read_string();
+		reply.read_double();
+		while (!reply.eom())
+			if (reply.read_uint8() == OPTION_ROW_LAYOUT) {
+				in.row_layout = true;
+				out.row_layout = true;
+			}
+
+		return true;
+	}
+};
+
+typedef std::shared_ptr<BenchConnection> BenchConnection_ptr;
+
+// Start, end (exclusive) and skip of the rows and then the columns of a block
+struct BlockDims {
+	uint64_t rows[3];
+	uint64_t cols[3];
+
+	uint64_t size() const
+	{
+		return ((rows[1] - rows[0] + rows[2] - 1)/rows[2])*((cols[1] - cols[0] + cols[2] - 1)/cols[2]);
+	}
+};
+
+struct BenchResult {
+	uint64_t num_bytes = 0;
+	uint64_t num_blocks = 0;
+	double time = 0.0;							// Wall-clock time in ms
+	vector<double> latencies;					// Round trip of each message in ms
+
+	void add(const BenchResult & other)
+	{
+		num_bytes += other.num_bytes;
+		num_blocks += other.num_blocks;
+		time += other.time;
+		latencies.insert(latencies.end(), other.latencies.begin(), other.latencies.end());
+	}
+
+	double percentile(const double p)
+	{
+		if (latencies.empty()) return 0.0;
+		std::sort(latencies.begin(), latencies.end());
+		size_t k = (size_t) std::ceil(p*latencies.size());
+
+		return latencies[std::min(std::max(k, (size_t) 1), latencies.size()) - 1];
+	}
+};
+
+// Splits the rows a worker holds into runs of at most block_rows rows with a common stride, and those into blocks of
+// at most block_cols columns
+vector<BlockDims> get_blocks(const vector<uint64_t> & rows, const uint64_t block_rows, const uint64_t block_cols,
+		const uint64_t num_cols)
+{
+	vector<BlockDims> blocks;
+
+	for (size_t k = 0; k < rows.size(); ) {
+		size_t n = 1;
+		uint64_t skip = (k+1 < rows.size()) ? rows[k+1] - rows[k] : 1;
+		while (n < block_rows && k+n < rows.size() && rows[k+n] - rows[k+n-1] == skip) n++;
+		if (n == 1) skip = 1;
+
+		for (uint64_t c = 0; c < num_cols; c += block_cols) {
+			BlockDims b = {{rows[k], rows[k+n-1] + 1, skip}, {c, std::min(c + block_cols, num_cols), 1}};
+			blocks.push_back(b);
+		}
+
+		k += n;
+	}
+
+	return blocks;
+}
+
+// Groups blocks into messages with at most max_bytes of data, and at least one block, each
+vector<vector<BlockDims>> get_messages(const vector<BlockDims> & blocks, const uint64_t max_bytes)
+{
+	vector<vector<BlockDims>> messages;
+	uint64_t num_bytes = 0;
+
+	for (const BlockDims & b : blocks) {
+		if (messages.empty() || num_bytes + 8*b.size() > max_bytes) {
+			messages.push_back(vector<BlockDims>());
+			num_bytes = 0;
+		}
+		messages.back().push_back(b);
+		num_bytes += 8*b.size();
+	}
+
+	return messages;
+}
+
+DoubleArrayBlock_ptr write_block(Message & msg, const BlockDims & b)
+{
+	DoubleArrayBlock_ptr block = std::make_shared<ArrayBlock<double>>(2);
+	for (int j = 0; j < 3; j++) {
+		block->dims[j][0] = b.rows[j];
+		block->dims[j][1] = b.cols[j];
+	}
+	block->size = b.size();
+
+	msg.write_DoubleArrayBlock(block);
+
+	return block;
+}
+
+// Sends (or requests) the blocks of each worker, with one thread per worker as a Spark job would have one task per
+// partition
+BenchResult transfer_blocks(vector<BenchConnection_ptr> & workers, const vector<vector<vector<BlockDims>>> & messages,
+		const ArrayID matrixID, const bool upload, const vector<double> & values)
+{
+	BenchResult result;
+	vector<BenchResult> worker_results(workers.size());
+	vector<std::thread> threads;
+
+	bench_clock::time_point start = bench_clock::now();
+
+	for (size_t w = 0; w < workers.size(); w++)
+		threads.push_back(std::thread([&, w]() {
+			BenchConnection & connection = *workers[w];
+			BenchResult & r = worker_results[w];
+
+			for (const vector<BlockDims> & blocks : messages[w]) {
+				Message & msg = connection.start(upload ? SEND_MATRIX_BLOCKS : REQUEST_MATRIX_BLOCKS);
+				if (upload) msg.write_ArrayID(matrixID);
+				else msg.write_uint16(matrixID);
+
+				for (const BlockDims & b : blocks) {
+					DoubleArrayBlock_ptr block = write_block(msg, b);
+					memcpy(block->start, values.data(), 8*block->size);
+					msg.finish_DoubleArrayBlock(block);
+					r.num_bytes += 8*block->size;
+				}
+				r.num_blocks += blocks.size();
+
+				bench_clock::time_point sent = bench_clock::now();
+				Message & reply = connection.exchange();
+				r.latencies.push_back(elapsed_ms(sent));
+
+				if (reply.ec != ERR_NONE) {
+					std::cerr << "Error from worker: " << get_error_name(reply.ec) << std::endl;
+					return;
+				}
+			}
+		}));
+
+	for (std::thread & t : threads) t.join();
+
+	for (BenchResult & r : worker_results) result.add(r);
+	result.time = elapsed_ms(start);
+
+	return result;
+}
+
+BenchResult run_tasks(BenchConnection & driver, const LibraryID libraryID, const string & task_name, const uint32_t num_tasks)
+{
+	BenchResult result;
+
+	bench_clock::time_point start = bench_clock::now();
+
+	for (uint32_t i = 0; i < num_tasks; i++) {
+		Message & msg = driver.start(RUN_TASK);
+		msg.write_LibraryID(libraryID);
+		msg.write_string(task_name);
+
+		bench_clock::time_point sent = bench_clock::now();
+		driver.exchange();
+		result.latencies.push_back(elapsed_ms(sent));
+	}
+
+	result.time = elapsed_ms(start);
+
+	return result;
+}
+
+void print_header()
+{
+	printf("%-9s %7s %12s %10s %10s %12s %9s %9s\n", "operation", "workers", "block", "message", "MB/s", "blocks/s",
+			"p50 ms", "p99 ms");
+}
+
+void print_result(const string & operation, const uint16_t num_workers, const string & block, const string & message,
+		BenchResult & r)
+{
+	double seconds = r.time/1000.0;
+
+	// Tasks have no blocks, so their rate is given in tasks/s instead
+	printf("%-9s %7u %12s %10s %10.1f %12.1f %9.3f %9.3f\n", operation.c_str(), num_workers, block.c_str(), message.c_str(),
+			r.num_bytes/1.0e6/seconds, (r.num_blocks > 0 ? r.num_blocks : r.latencies.size())/seconds,
+			r.percentile(0.50), r.percentile(0.99));
+	fflush(stdout);
+}
+
+vector<uint64_t> parse_list(const string & s)
+{
+	vector<uint64_t> x;
+	std::stringstream ss(s);
+	string item;
+
+	while (std::getline(ss, item, ',')) x.push_back(std::stoull(item));
+
+	return x;
+}
+
+bool parse_options(int argc, char ** argv, BenchOptions & options)
+{
+	for (int i = 1; i < argc; i++) {
+		string option = argv[i];
+		if (i+1 >= argc) return false;
+		string value = argv[++i];
+
+		if (option == "--host") options.host = value;
+		else if (option == "--port") options.port = (uint16_t) std::stoul(value);
+		else if (option == "--workers") options.num_workers = (uint16_t) std::stoul(value);
+		else if (option == "--rows") options.num_rows = std::stoull(value);
+		else if (option == "--cols") options.num_cols = std::stoull(value);
+		else if (option == "--block-rows") options.block_rows = parse_list(value);
+		else if (option == "--block-cols") options.block_cols = parse_list(value);
+		else if (option == "--message-kb") options.message_kb = parse_list(value);
+		else if (option == "--repeats") options.num_repeats = (uint32_t) std::stoul(value);
+		else if (option == "--tasks") options.num_tasks = (uint32_t) std::stoul(value);
+		else if (option == "--library") options.library_path = value;
+		else return false;
+	}
+
+	return true;
+}
+
+int run_benchmarks(const BenchOptions & options)
+{
+	io_context _io_context;
+
+	BenchConnection driver(_io_context);
+	if (!driver.connect(options.host, options.port)) {
+		std::cerr << "Handshake with the driver failed" << std::endl;
+		return 1;
+	}
+
+	Message & request = driver.start(REQUEST_WORKERS);
+	request.write_uint16(options.num_workers);
+	Message & allocation = driver.exchange();
+	if (allocation.ec != ERR_NONE) {
+		std::cerr << "Unable to get workers: " << get_error_name(allocation.ec) << std::endl;
+		return 1;
+	}
+
+	uint16_t num_workers = allocation.read_uint16();
+	vector<WorkerInfo_ptr> worker_info;
+	for (uint16_t i = 0; i < num_workers; i++) worker_info.push_back(allocation.read_WorkerInfo());
+
+	vector<WorkerID> workerIDs;
+	map<WorkerID, size_t> worker_index;
+	vector<BenchConnection_ptr> workers;
+
+	for (WorkerInfo_ptr info : worker_info) {
+		worker_index[info->ID] = workers.size();
+		workerIDs.push_back(info->ID);
+		workers.push_back(std::make_shared<BenchConnection>(_io_context));
+		if (!workers.back()->connect(info->address, info->port)) {
+			std::cerr << "Handshake with worker " << info->ID << " failed" << std::endl;
+			return 1;
+		}
+	}
+
+	// Matrix that all transfers write into and read from
+	// The layout is chosen by Alchemist, so none is sent
+	ArrayInfo_ptr new_matrix = std::make_shared<ArrayInfo>(0, string("bench"), options.num_rows, options.num_cols);
+	new_matrix->worker_assignments.clear();
+
+	Message & info_msg = driver.start(SEND_MATRIX_INFO);
+	info_msg.write_ArrayInfo(new_matrix);
+	ArrayInfo_ptr matrix = driver.exchange().read_ArrayInfo();
+
+	vector<vector<uint64_t>> worker_rows(num_workers);
+	for (uint64_t i = 0; i < matrix->num_rows; i++) {
+		auto it = worker_index.find(matrix->worker_assignments[i]);
+		if (it == worker_index.end()) {
+			std::cerr << "Row " << i << " is on worker " << matrix->worker_assignments[i] << ", which was not allocated" << std::endl;
+			return 1;
+		}
+		worker_rows[it->second].push_back(i);
+	}
+
+	print_header();
+
+	for (uint64_t block_rows : options.block_rows)
+		for (uint64_t block_cols : options.block_cols) {
+			if (block_cols == 0 || block_cols > options.num_cols) block_cols = options.num_cols;
+
+			vector<vector<BlockDims>> worker_blocks(num_workers);
+			uint64_t max_block_size = 0;
+			for (uint16_t w = 0; w < num_workers; w++) {
+				worker_blocks[w] = get_blocks(worker_rows[w], block_rows, block_cols, options.num_cols);
+				for (const BlockDims & b : worker_blocks[w]) max_block_size = std::max(max_block_size, b.size());
+			}
+
+			vector<double> values(max_block_size);
+			for (uint64_t k = 0; k < max_block_size; k++) values[k] = 1.0 + 1.0e-3*k;
+
+			string block = std::to_string(block_rows) + "x" + std::to_string(block_cols);
+
+			for (uint64_t kb : options.message_kb) {
+				vector<vector<vector<BlockDims>>> messages(num_workers);
+				for (uint16_t w = 0; w < num_workers; w++) messages[w] = get_messages(worker_blocks[w], 1024*kb);
+
+				string message = std::to_string(kb) + "KB";
+
+				BenchResult upload, download;
+				for (uint32_t r = 0; r < options.num_repeats; r++) {
+					upload.add(transfer_blocks(workers, messages, matrix->ID, true, values));
+					download.add(transfer_blocks(workers, messages, matrix->ID, false, values));
+				}
+
+				print_result("upload", num_workers, block, message, upload);
+				print_result("download", num_workers, block, message, download);
+			}
+		}
+
+	if (!options.library_path.empty()) {
+		Message & load_msg = driver.start(LOAD_LIBRARY);
+		load_msg.write_string(string("TestLibrary"));
+		load_msg.write_string(options.library_path);
+		LibraryID libraryID = driver.exchange().read_LibraryID();
+
+		for (const string task_name : {"noop", "barrier"}) {
+			BenchResult r = run_tasks(driver, libraryID, task_name, options.num_tasks);
+			print_result(task_name, num_workers, "-", "-", r);
+		}
+	}
+
+	Message & yield_msg = driver.start(YIELD_WORKERS);
+	yield_msg.write_uint16_array(workerIDs);
+	driver.exchange();
+
+	return 0;
+}
+
+}			// namespace alchemist
+
+int main(int argc, char ** argv)
+{
+	alchemist::BenchOptions options;
+
+	if (!alchemist::parse_options(argc, argv, options)) {
+		std::cerr << "Usage: " << argv[0] << " [--host HOST] [--port PORT] [--workers N] [--rows N] [--cols N]" << std::endl;
+		std::cerr << "       [--block-rows N,...] [--block-cols N,...] [--message-kb N,...] [--repeats N]" << std::endl;
+		std::cerr << "       [--tasks N] [--library PATH]" << std::endl;
+		return 1;
+	}
+
+	try {
+		return alchemist::run_benchmarks(options);
+	}
+	catch (std::exception & e) {
+		std::cerr << "Exception while running benchmarks: " << e.what() << std::endl;
+		return 1;
+	}
+}
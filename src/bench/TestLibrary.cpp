@@ -0,0 +1,47 @@
+#include "../main/Library.hpp"
+
+namespace alchemist {
+
+// Alchemist only declares the constructor of the library interface, so every library has to provide it
+Library::Library(MPI_Comm & _world) : world(_world) { }
+
+// Trivial library for benchmarking the cost of running a task, as opposed to the cost of the task itself:
+//
+//   noop      returns straight away
+//   barrier   waits for every process running the task
+struct TestLibrary : Library {
+
+	TestLibrary(MPI_Comm & _world) : Library(_world) { }
+
+	int load() { return 0; }
+
+	int unload() { return 0; }
+
+	int run(string & task_name, Parameters & in, Parameters & out)
+	{
+		if (task_name.compare("noop") == 0) return 0;
+
+		if (task_name.compare("barrier") == 0) {
+			MPI_Barrier(world);
+			return 0;
+		}
+
+		return 1;
+	}
+};
+
+}			// namespace alchemist
+
+extern "C" {
+
+void * create_library(MPI_Comm & world)
+{
+	return static_cast<alchemist::Library *>(new alchemist::TestLibrary(world));
+}
+
+void destroy_library(void * p)
+{
+	delete static_cast<alchemist::Library *>(p);
+}
+
+}
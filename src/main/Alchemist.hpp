@@ -1,10 +1,13 @@
 #ifndef ALCHEMIST__ALCHEMIST_HPP
 #define ALCHEMIST__ALCHEMIST_HPP
 
+#include <algorithm>
 #include <cstdlib>
 #include <deque>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <set>
@@ -26,12 +29,25 @@
 #include <boost/thread.hpp>
 #endif
 #include <El.hpp>
+#ifdef ALCHEMIST_HDF5
+#include <hdf5.h>
+#endif
 #include "mpi.h"
 #include "utility/endian.hpp"
+#include "utility/byte_swap.hpp"
 #include "utility/client_language.hpp"
 #include "utility/command.hpp"
 #include "utility/logging.hpp"
 #include "utility/datatype.hpp"
+#include "utility/shared_memory.hpp"
+#include "utility/topology.hpp"
+#include "utility/allocation_policy.hpp"
+#include "utility/matrix_file.hpp"
+#include "utility/matrix_snapshot.hpp"
+#include "utility/text_parser.hpp"
+#include "utility/expression.hpp"
+#include "utility/column_stats.hpp"
+#include "utility/random_matrix.hpp"
 
 #define UNLIKELY(x) __builtin_expect(!!(x), 0)
 
@@ -71,6 +87,7 @@ const string get_Alchemist_version();
 const string get_Boost_version();
 
 typedef El::Matrix<double> Array;
+typedef std::shared_ptr<El::Matrix<double>> LocalMatrix_ptr;
 
 typedef uint16_t WorkerID;
 typedef uint16_t ClientID;
@@ -110,12 +127,13 @@ struct WorkerInfo {
 	WorkerInfo(WorkerID ID, string _hostname, string _address, uint16_t _port) :
 		WorkerInfo(ID, _hostname, _address, _port, 0) { }
 	WorkerInfo(WorkerID ID, string _hostname, string _address, uint16_t _port, GroupID groupID) :
-		ID(ID), hostname(_hostname), address(_address), port(_port), groupID(groupID)  { }
+		ID(ID), hostname(_hostname), address(_address), port(_port), groupID(groupID), socket(-1), numa_node(-1)  { }
 
 	WorkerID ID;
 	string hostname, address;
 	uint16_t port;
 	GroupID groupID;
+	int16_t socket, numa_node;			// -1 if not known
 
 	string to_string(bool include_allocation=true) const {
 		std::stringstream ss;
@@ -123,6 +141,8 @@ struct WorkerInfo {
 
 		sprintf(buffer, "%03d", ID);
 		ss << "Worker-" << string(buffer) << " running on " << hostname << " at " << address << ":" << port;
+		if (numa_node >= 0) ss << " (NUMA node " << numa_node << ")";
+		else if (socket >= 0) ss << " (socket " << socket << ")";
 		if (include_allocation)
 			(groupID > 0) ? ss << " - ACTIVE (group " << groupID << ")" : ss << " - IDLE";
 
@@ -137,30 +157,34 @@ struct ArrayInfo {
 	uint64_t num_rows, num_cols;
 	uint8_t sparse, layout, num_partitions;
 
-	uint16_t * worker_assignments;
+	vector<WorkerID> worker_assignments;			// Worker holding each row
 
-	explicit ArrayInfo() : ID(0), name(""), num_rows(1), num_cols(1), sparse(0), layout(0), num_partitions(1), worker_assignments(nullptr) {
-		worker_assignments = new uint16_t[num_partitions]();
-	}
+	explicit ArrayInfo() : ID(0), name(""), num_rows(1), num_cols(1), sparse(0), layout(0), num_partitions(1), worker_assignments(num_rows, 0) { }
 
 	ArrayInfo(ArrayID ID, uint64_t _num_rows, uint64_t _num_cols) :
-		ID(ID), name(""), num_rows(_num_rows), num_cols(_num_cols), sparse(0), layout(0), num_partitions(1), worker_assignments(nullptr) {
-		worker_assignments = new uint16_t[num_partitions]();
-	}
+		ID(ID), name(""), num_rows(_num_rows), num_cols(_num_cols), sparse(0), layout(0), num_partitions(1), worker_assignments(num_rows, 0) { }
 
 	ArrayInfo(ArrayID ID, string _name, uint64_t _num_rows, uint64_t _num_cols) :
-		ID(ID), name(_name), num_rows(_num_rows), num_cols(_num_cols), sparse(0), layout(0), num_partitions(1), worker_assignments(nullptr) {
-		worker_assignments = new uint16_t[num_partitions]();
-	}
+		ID(ID), name(_name), num_rows(_num_rows), num_cols(_num_cols), sparse(0), layout(0), num_partitions(1), worker_assignments(num_rows, 0) { }
 
 	ArrayInfo(ArrayID ID, string _name, uint64_t _num_rows, uint64_t _num_cols, uint8_t _sparse, uint8_t _layout, uint8_t _num_partitions) :
-		ID(ID), name(_name), num_rows(_num_rows), num_cols(_num_cols), sparse(_sparse), layout(0), num_partitions(_num_partitions), worker_assignments(nullptr) {
-		worker_assignments = new uint16_t[num_partitions]();
+		ID(ID), name(_name), num_rows(_num_rows), num_cols(_num_cols), sparse(_sparse), layout(0), num_partitions(_num_partitions), worker_assignments(num_rows, 0) { }
+
+	// Rows are dealt out to the partitions in turn, so partition p holds rows p, p + num_partitions, ... and lives on
+	// the worker holding row p
+	vector<WorkerID> get_partition_workers() const {
+		vector<WorkerID> partition_workers(num_partitions, 0);
+		for (uint64_t p = 0; p < num_partitions && p < worker_assignments.size(); p++)
+			partition_workers[p] = worker_assignments[p];
+
+		return partition_workers;
 	}
 
-	~ArrayInfo() {
-		delete [] worker_assignments;
-		worker_assignments = nullptr;
+	void set_partition_workers(const vector<WorkerID> & partition_workers) {
+		if (partition_workers.empty()) return;
+
+		for (uint64_t i = 0; i < worker_assignments.size(); i++)
+			worker_assignments[i] = partition_workers[i % partition_workers.size()];
 	}
 
 	string to_string(bool display_layout=false) const {
@@ -192,9 +216,10 @@ struct ArrayBlock {
 				dims[j][i] = block.dims[j][i];
 		}
 
+		// Ends are exclusive, as in GroupWorker::set_block and get_block
 		size = 1;
 		for (int i = 0; i < ndims; i++)
-			size *= std::ceil((1.0*dims[1][i] - dims[0][i] + 1.0)/dims[2][i]);
+			size *= (dims[1][i] > dims[0][i]) ? (dims[1][i] - dims[0][i] + dims[2][i] - 1)/dims[2][i] : 0;
 	}
 
 	~ArrayBlock()
@@ -264,6 +289,28 @@ struct ArrayBlock {
 	}
 };
 
+// Non-owning view of a contiguous array, e.g. of array data inside a message
+template <typename T>
+struct ArraySpan {
+	ArraySpan() : ptr(nullptr), length(0) { }
+	ArraySpan(const T * _ptr, size_t _length) : ptr(_ptr), length(_length) { }
+	ArraySpan(const vector<T> & x) : ptr(x.data()), length(x.size()) { }
+
+	const T * ptr;
+	size_t length;
+
+	const T * data() const { return ptr; }
+	size_t size() const { return length; }
+	bool empty() const { return length == 0; }
+
+	const T & operator[](size_t i) const { return ptr[i]; }
+
+	const T * begin() const { return ptr; }
+	const T * end() const { return ptr + length; }
+
+	vector<T> to_vector() const { return vector<T>(ptr, ptr + length); }
+};
+
 typedef std::shared_ptr<WorkerInfo> WorkerInfo_ptr;
 typedef std::shared_ptr<ArrayInfo> ArrayInfo_ptr;
 typedef std::shared_ptr<ArrayBlock<float>> FloatArrayBlock_ptr;
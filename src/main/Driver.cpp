@@ -9,18 +9,30 @@ Driver::Driver(io_context & _io_context, const unsigned int port) :
 				Driver(_io_context, tcp::endpoint(tcp::v4(), port)) { }
 
 Driver::Driver(io_context & _io_context, const tcp::endpoint & endpoint) :
-				Server(_io_context, endpoint), next_matrixID(0), next_groupID(0)
+				Server(_io_context, endpoint), next_matrixID(0), next_groupID(0), next_request_sequence(0)
 {
 	log = start_log("driver", "[%Y-%m-%d %H:%M:%S.%e] [%n] [%l]        %^%v%$", bold, iwhite);
 	Server::set_log(log);
 
 	world = MPI_COMM_WORLD;
+	MPI_Comm_dup(world, &control);
+	register_allocation_policies();
 
 	int world_size;
 	MPI_Comm_size(world, &world_size);
 
 	num_workers = (uint16_t) world_size - 1;
 
+	// Without a quota every tenant may use all the workers
+	default_tenant_quota = num_workers;
+	const char * tenant_quota = std::getenv("ALCHEMIST_TENANT_QUOTA");
+	if (tenant_quota != nullptr && std::atoi(tenant_quota) > 0)
+		default_tenant_quota = (uint16_t) std::min(std::atoi(tenant_quota), (int) num_workers);
+
+	const char * coordinator = std::getenv("ALCHEMIST_COORDINATOR_ONLY");
+	coordinator_only = (coordinator != nullptr && std::atoi(coordinator) != 0);
+	if (coordinator_only) log->info("Driver only coordinates, tasks run on the workers alone");
+
 	print_welcome_message();
 
 	log->info("Starting workers");
@@ -31,10 +43,8 @@ Driver::Driver(io_context & _io_context, const tcp::endpoint & endpoint) :
 
 	print_ready_message();
 
-	std::thread t = std::thread(&Driver::accept_connection, this);
-
-//	print_workers();
-	t.join();
+	accept_connection();
+	run_io_threads();
 }
 
 Driver::~Driver() { }
@@ -109,68 +119,127 @@ void Driver::print_ready_message()
 //	return allocated_workers[sessionID];
 //}
 
+// Only the driver and the workers of the group take part: the group's description is sent to each of them over the
+// control communicator, and the new communicator is created with the group's ID as tag so that other groups can be
+// formed at the same time. Other groups, and idle workers, are not involved.
 void Driver::set_group_communicator(const GroupID & groupID)
 {
-//	std::lock_guard<std::mutex> lock(worker_mutex);
+	GroupDriver_ptr group;
+	vector<WorkerID> group_key;
+	group_comm_source comm_source = NEW_GROUP_COMM;
+	MPI_Comm cached_comm = MPI_COMM_NULL;
 
-	uint16_t group_size = (uint16_t) groups[groupID]->workers.size();
-	uint16_t workerID, peerID;
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		group = groups[groupID];
 
-	int groupIDs[group_size+1];
-	int group_peerIDs[group_size];
-	groupIDs[0] = 0;
+		// Workers are kept in a map, so the key is already sorted
+		for (auto it = group->workers.begin(); it != group->workers.end(); it++)
+			group_key.push_back(it->first);
 
-	int i = 1;
-	for (auto it = groups[groupID]->workers.begin(); it != groups[groupID]->workers.end(); it++) {
-		groupIDs[i] = it->first;
-		group_peerIDs[i-1] = it->first;
-		i++;
+		auto it = group_comms.find(group_key);
+		if (it != group_comms.end()) {
+			comm_source = CACHED_GROUP_COMM;
+			cached_comm = it->second;
+		}
+		else if (group_comms.size() < max_cached_group_comms) comm_source = NEW_CACHED_GROUP_COMM;
 	}
 
-	MPI_Group world_group;
-	MPI_Group temp_group;
-	MPI_Group temp_peer_group;
+	uint16_t group_size = (uint16_t) group_key.size();
+	const vector<WorkerID> & previous_key = group->formed_workers;
 
-	MPI_Comm_group(world, &world_group);
+	// Matrices live on the grid of the workers the group was last formed with, so they are moved whenever the group
+	// gets a different grid
+	bool redistribute = group->has_matrices() && !previous_key.empty() &&
+			!(previous_key == group_key && comm_source == CACHED_GROUP_COMM);
 
-	MPI_Group_incl(world_group, (int) (group_size+1), groupIDs, &temp_group);
-	MPI_Group_incl(world_group, (int) group_size, group_peerIDs, &temp_peer_group);
+	if (redistribute && group_size == 0) {
+		log->info("Group {} has no workers left, its matrices are lost", groupID);
+		redistribute = false;
+	}
 
-	alchemist_command command = _AM_NEW_GROUP;
+	vector<WorkerID> departing_workers;
+	if (redistribute)
+		std::set_difference(previous_key.begin(), previous_key.end(), group_key.begin(), group_key.end(),
+				std::back_inserter(departing_workers));
+
+	log->info("Forming group {} with {} workers", groupID, group_size);
+	group->free_group();
+
+	// Group ID, how to get the communicators, the part the receiving worker plays, the workers in the group and, if
+	// the group's matrices have to be moved, the workers the group was formed with before
+	uint16_t num_previous = redistribute ? (uint16_t) previous_key.size() : 0;
+	vector<int> description(5 + group_size + num_previous);
+	description[0] = groupID;
+	description[1] = comm_source;
+	description[3] = group_size;
+	for (uint16_t i = 0; i < group_size; i++) description[4+i] = group_key[i];
+	description[4+group_size] = num_previous;
+	for (uint16_t i = 0; i < num_previous; i++) description[5+group_size+i] = previous_key[i];
+
+	for (uint16_t i = 0; i < group_size; i++) {
+		description[2] = (i == 0) ? PRIMARY_GROUP_MEMBER : GROUP_MEMBER;
+		MPI_Send(description.data(), (int) description.size(), MPI_INT, group_key[i], NEW_GROUP_TAG, control);
+	}
 
-	log->info("Sending command {} to {} workers", get_command_name(command), group_size);
-	groups[groupID]->free_group();
+	description[2] = DEPARTING_GROUP_MEMBER;
+	for (WorkerID workerID: departing_workers)
+		MPI_Send(description.data(), (int) description.size(), MPI_INT, workerID, NEW_GROUP_TAG, control);
 
-	MPI_Request req;
-	MPI_Status status;
-	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, world, &req);
-	MPI_Wait(&req, &status);
+	if (comm_source == CACHED_GROUP_COMM) {
+		log->info("Reusing communicator of earlier group with the same workers");
+		group->reuse_group_comm(cached_comm);
+	}
+	else {
+		int groupIDs[group_size+1];
+		groupIDs[0] = 0;
+		for (uint16_t i = 0; i < group_size; i++) groupIDs[i+1] = group_key[i];
+
+		MPI_Group world_group;
+		MPI_Group temp_group;
 
-	uint16_t num_workers = (uint16_t) workers.size();
-	GroupID null_groupID = 0;
-
-	int primary_group_worker = 0;
-
-	for (int j = 1; j <= num_workers; j++) {
-		workerID = j;
-		if (groups[groupID]->workers.find(workerID) == groups[groupID]->workers.end() )
-			MPI_Send(&null_groupID, 1, MPI_UNSIGNED_SHORT, workerID, 0, world);
-		else {
-			MPI_Send(&groupID, 1, MPI_UNSIGNED_SHORT, workerID, 0, world);
-			MPI_Send(&group_size, 1, MPI_UNSIGNED_SHORT, workerID, 0, world);
-			MPI_Send(&group_peerIDs, (int) group_size, MPI_INT, workerID, 0, world);
-			MPI_Send(&primary_group_worker, 1, MPI_INT, workerID, 0, world);
-			if (primary_group_worker == 0) primary_group_worker = 1;
+		MPI_Comm_group(world, &world_group);
+		MPI_Group_incl(world_group, (int) (group_size+1), groupIDs, &temp_group);
+
+		group->set_group_comm(world, temp_group, comm_source == NEW_CACHED_GROUP_COMM);
+		if (comm_source == NEW_CACHED_GROUP_COMM) {
+			std::lock_guard<std::mutex> lock(worker_mutex);
+			group_comms.insert(std::make_pair(group_key, group->get_group_comm()));
 		}
+
+		MPI_Group_free(&world_group);
+		MPI_Group_free(&temp_group);
 	}
-	groups[groupID]->set_group_comm(world, temp_group);
 
-	groups[groupID]->ready_group();
+	if (redistribute) {
+		// The driver, the previous and the new workers; created on the control communicator so that it cannot get in
+		// the way of the creation of the group's communicators
+		vector<WorkerID> handover_workers;
+		std::set_union(previous_key.begin(), previous_key.end(), group_key.begin(), group_key.end(),
+				std::back_inserter(handover_workers));
+
+		int handoverIDs[handover_workers.size()+1];
+		handoverIDs[0] = 0;
+		for (size_t i = 0; i < handover_workers.size(); i++) handoverIDs[i+1] = handover_workers[i];
 
-	MPI_Group_free(&world_group);
-	MPI_Group_free(&temp_group);
-	MPI_Group_free(&temp_peer_group);
-//	MPI_Barrier(world);
+		MPI_Group control_group;
+		MPI_Group temp_group;
+		MPI_Comm handover;
+
+		MPI_Comm_group(control, &control_group);
+		MPI_Group_incl(control_group, (int) (handover_workers.size()+1), handoverIDs, &temp_group);
+		MPI_Comm_create_group(control, temp_group, groupID, &handover);
+
+		group->redistribute_matrices(handover, handover_workers);
+
+		MPI_Comm_free(&handover);
+		MPI_Group_free(&control_group);
+		MPI_Group_free(&temp_group);
+	}
+
+	group->formed_workers = group_key;
+	group->ready_group();
 }
 
 // -----------------------------------------   Workers   -----------------------------------------
@@ -210,6 +279,7 @@ int Driver::register_workers()
 	MPI_Wait(&req, &status);
 
 	uint16_t hostname_length, address_length, port;
+	int16_t socket, numa_node;
 
 	for (WorkerID workerID = 1; workerID <= num_workers; ++workerID) {
 		MPI_Recv(&hostname_length, 1, MPI_UNSIGNED_SHORT, workerID, 0, world, &status);
@@ -219,8 +289,13 @@ int Driver::register_workers()
 		char address[address_length];
 		MPI_Recv(address, address_length, MPI_CHAR, workerID, 0, world, &status);
 		MPI_Recv(&port, 1, MPI_UNSIGNED_SHORT, workerID, 0, world, &status);
+		MPI_Recv(&socket, 1, MPI_SHORT, workerID, 0, world, &status);
+		MPI_Recv(&numa_node, 1, MPI_SHORT, workerID, 0, world, &status);
 
-		workers.insert(std::make_pair(workerID, std::make_shared<WorkerInfo>(workerID, string(hostname), string(address), port)));
+		WorkerInfo_ptr info = std::make_shared<WorkerInfo>(workerID, string(hostname), string(address), port);
+		info->socket = socket;
+		info->numa_node = numa_node;
+		workers.insert(std::make_pair(workerID, info));
 
 		unallocated_workers.push_back(workerID);
 	}
@@ -239,26 +314,166 @@ int Driver::register_workers()
 	return 0;
 }
 
-uint16_t Driver::allocate_workers(const GroupID groupID, const uint16_t & num_requested_workers)
+// ---------------------------------------   Allocation   ----------------------------------------
+
+// Each policy picks the given number of workers out of the available ones, which are sorted by ID
+
+static vector<WorkerID> allocate_in_order(const vector<WorkerInfo_ptr> & available, const uint16_t num_workers)
+{
+	vector<WorkerID> selected;
+
+	for (uint16_t i = 0; i < num_workers && i < available.size(); i++)
+		selected.push_back(available[i]->ID);
+
+	return selected;
+}
+
+// Available workers per host, with hosts in the order they first appear
+static vector<vector<WorkerInfo_ptr> > group_by_host(const vector<WorkerInfo_ptr> & available)
+{
+	vector<vector<WorkerInfo_ptr> > hosts;
+	map<string, size_t> host_index;
+
+	for (auto & info: available) {
+		auto it = host_index.find(info->hostname);
+		if (it == host_index.end()) {
+			host_index.insert(std::make_pair(info->hostname, hosts.size()));
+			hosts.push_back(vector<WorkerInfo_ptr>(1, info));
+		}
+		else hosts[it->second].push_back(info);
+	}
+
+	return hosts;
+}
+
+// Fills up hosts with the most available workers first, but if a single host can take the whole group, uses the
+// smallest such host so that larger ones stay free for larger groups. With by_numa_node, the workers on each host
+// are taken one NUMA node (or, if that is not known, one socket) at a time, starting with the node that has the most
+// available workers.
+static vector<WorkerID> allocate_packed(const vector<WorkerInfo_ptr> & available, const uint16_t num_workers, const bool by_numa_node)
+{
+	auto domain = [](const WorkerInfo_ptr & info) { return (info->numa_node >= 0) ? info->numa_node : info->socket; };
+
+	if (by_numa_node) {
+		// Best of all is the smallest NUMA node that can take the whole group
+		map<std::pair<string, int16_t>, vector<WorkerID> > domains;
+		for (auto & info: available) domains[std::make_pair(info->hostname, domain(info))].push_back(info->ID);
+
+		const vector<WorkerID> * best = nullptr;
+		for (auto & d: domains)
+			if (d.second.size() >= num_workers && (best == nullptr || d.second.size() < best->size())) best = &d.second;
+
+		if (best != nullptr) return vector<WorkerID>(best->begin(), best->begin() + num_workers);
+	}
+
+	vector<vector<WorkerInfo_ptr> > hosts = group_by_host(available);
+
+	std::stable_sort(hosts.begin(), hosts.end(), [](const vector<WorkerInfo_ptr> & a, const vector<WorkerInfo_ptr> & b) {
+		return a.size() > b.size();
+	});
+
+	for (auto it = hosts.rbegin(); it != hosts.rend(); it++) {
+		if (it->size() >= num_workers) {
+			std::rotate(hosts.begin(), it.base() - 1, it.base());
+			break;
+		}
+	}
+
+	vector<WorkerID> selected;
+
+	for (auto & host: hosts) {
+		if (by_numa_node) {
+			map<int16_t, uint16_t> domain_size;
+
+			for (auto & info: host) domain_size[domain(info)]++;
+
+			std::stable_sort(host.begin(), host.end(), [&](const WorkerInfo_ptr & a, const WorkerInfo_ptr & b) {
+				if (domain(a) == domain(b)) return false;
+				if (domain_size[domain(a)] != domain_size[domain(b)]) return domain_size[domain(a)] > domain_size[domain(b)];
+				return domain(a) < domain(b);
+			});
+		}
+
+		for (auto & info: host) {
+			if (selected.size() == num_workers) return selected;
+			selected.push_back(info->ID);
+		}
+	}
+
+	return selected;
+}
+
+static vector<WorkerID> allocate_pack_hosts(const vector<WorkerInfo_ptr> & available, const uint16_t num_workers)
+{
+	return allocate_packed(available, num_workers, false);
+}
+
+static vector<WorkerID> allocate_pack_numa(const vector<WorkerInfo_ptr> & available, const uint16_t num_workers)
 {
-	uint16_t num_allocated_workers = std::min(num_requested_workers, (uint16_t) unallocated_workers.size());
+	return allocate_packed(available, num_workers, true);
+}
 
+// Takes one worker from each host in turn
+static vector<WorkerID> allocate_spread_hosts(const vector<WorkerInfo_ptr> & available, const uint16_t num_workers)
+{
+	vector<vector<WorkerInfo_ptr> > hosts = group_by_host(available);
+	vector<WorkerID> selected;
+
+	for (size_t round = 0; selected.size() < num_workers && selected.size() < available.size(); round++)
+		for (auto & host: hosts)
+			if (round < host.size() && selected.size() < num_workers) selected.push_back(host[round]->ID);
+
+	return selected;
+}
+
+void Driver::register_allocation_policies()
+{
+	allocation_policies[ALLOCATE_IN_ORDER] = allocate_in_order;
+	allocation_policies[ALLOCATE_PACK_HOSTS] = allocate_pack_hosts;
+	allocation_policies[ALLOCATE_SPREAD_HOSTS] = allocate_spread_hosts;
+	allocation_policies[ALLOCATE_PACK_NUMA] = allocate_pack_numa;
+}
+
+void Driver::set_allocation_policy(const allocation_policy policy, allocation_function f)
+{
 	std::lock_guard<std::mutex> lock(worker_mutex);
 
-	if (num_allocated_workers > 0) {
+	allocation_policies[policy] = f;
+}
 
-		WorkerID workerID;
-		GroupID _groupID = groupID;
+uint16_t Driver::allocate_workers(const GroupID groupID, const uint16_t & num_requested_workers, const allocation_policy policy)
+{
+	uint16_t num_allocated_workers;
 
-		for (uint16_t i = 0; i < num_allocated_workers; i++) {
-			workerID = unallocated_workers[i];
-			workers.find(workerID)->second->groupID = _groupID;
+	{
+		// Only the bookkeeping is done under the lock; forming the group only involves the group's workers
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		vector<WorkerInfo_ptr> available;
+		for (WorkerID workerID: unallocated_workers) available.push_back(workers.find(workerID)->second);
+
+		auto allocate = allocation_policies.find(policy);
+		if (allocate == allocation_policies.end()) {
+			log->info("Unknown allocation policy {}, allocating workers in order", (uint16_t) policy);
+			allocate = allocation_policies.find(ALLOCATE_IN_ORDER);
+		}
+		else if (policy != ALLOCATE_IN_ORDER)
+			log->info("Allocating workers with policy {}", get_allocation_policy_name(policy));
+
+		vector<WorkerID> selected_workers = allocate->second(available, std::min(num_requested_workers, (uint16_t) available.size()));
+		num_allocated_workers = (uint16_t) selected_workers.size();
+
+		for (WorkerID workerID: selected_workers) {
+			workers.find(workerID)->second->groupID = groupID;
 			groups[groupID]->add_worker(workerID, workers.find(workerID)->second);
+			unallocated_workers.erase(std::find(unallocated_workers.begin(), unallocated_workers.end(), workerID));
 		}
-		unallocated_workers.erase(unallocated_workers.begin(), unallocated_workers.begin() + num_requested_workers);
 
-		set_group_communicator(groupID);
+		tenant_workers[group_tenants[groupID]] += num_allocated_workers;
 	}
+
+	if (num_allocated_workers > 0)
+		set_group_communicator(groupID);
 	else
 		log->info(string("No workers available to be allocated"));
 
@@ -318,30 +533,204 @@ uint16_t Driver::allocate_workers(const GroupID groupID, const uint16_t & num_re
 
 vector<WorkerID> Driver::deallocate_workers(const GroupID groupID, const vector<WorkerID> & selected_workers)
 {
-	std::lock_guard<std::mutex> lock(worker_mutex);
-
 	vector<WorkerID> deallocated_workers;
 
-	for (auto it = selected_workers.begin(); it != selected_workers.end(); it++) {
-		unallocated_workers.push_back(*it);
-		deallocated_workers.push_back(*it);
-		workers.find(*it)->second->groupID = 0;
-		groups[groupID]->remove_worker(*it);
-	}
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
 
-	sort(unallocated_workers.begin(), unallocated_workers.end());
+		// Workers may be listed more than once, and only those still in the group can be given back
+		vector<WorkerID> requested_workers(selected_workers);
+		sort(requested_workers.begin(), requested_workers.end());
+		requested_workers.erase(std::unique(requested_workers.begin(), requested_workers.end()), requested_workers.end());
+
+		for (WorkerID workerID: requested_workers) {
+			if (groups[groupID]->workers.find(workerID) == groups[groupID]->workers.end()) continue;
+
+			deallocated_workers.push_back(workerID);
+			workers.find(workerID)->second->groupID = 0;
+			groups[groupID]->remove_worker(workerID);
+		}
+
+		if (deallocated_workers.empty()) return deallocated_workers;
+	}
 
 	set_group_communicator(groupID);
 
+	{
+		// Departing workers only go back to the pool once they have handed over the group's matrices, since another
+		// group's description must not reach them while they are still taking part in the handover
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		unallocated_workers.insert(unallocated_workers.end(), deallocated_workers.begin(), deallocated_workers.end());
+		sort(unallocated_workers.begin(), unallocated_workers.end());
+
+		uint16_t & num_held_workers = tenant_workers[group_tenants[groupID]];
+		num_held_workers -= std::min(num_held_workers, (uint16_t) deallocated_workers.size());
+	}
+
 	log->info(list_all_workers());
 
+	serve_queued_requests();
+
 	return deallocated_workers;
 }
 
+// Gives back all of the workers of a group whose client has gone and drops its waiting requests, so that they no
+// longer count against its tenant's quota
+void Driver::release_group(const GroupID groupID)
+{
+	vector<WorkerID> held_workers;
+
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		for (auto it = queued_requests.begin(); it != queued_requests.end(); ) {
+			if (it->groupID == groupID) {
+				it->timer->cancel();
+				it = queued_requests.erase(it);
+			}
+			else it++;
+		}
+
+		for (auto it = groups[groupID]->workers.begin(); it != groups[groupID]->workers.end(); it++)
+			held_workers.push_back(it->first);
+	}
+
+	if (!held_workers.empty()) {
+		log->info("Releasing the {} workers of group {}", held_workers.size(), groupID);
+		deallocate_workers(groupID, held_workers);
+	}
+	else serve_queued_requests();
+}
+
+// ------------------------------------   Admission Control   ------------------------------------
+
+void Driver::set_tenant_quota(const string & tenant, const uint16_t max_workers)
+{
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
+	tenant_quotas[tenant] = max_workers;
+}
+
+uint16_t Driver::get_tenant_quota(const string & tenant) const
+{
+	auto it = tenant_quotas.find(tenant);
+
+	return (it != tenant_quotas.end()) ? it->second : default_tenant_quota;
+}
+
+bool Driver::request_workers(const GroupID groupID, const string & tenant, const uint16_t num_requested_workers, const allocation_policy policy,
+		const uint8_t priority, const uint32_t timeout, worker_request_handler handler)
+{
+	uint16_t num_available_workers;
+	alchemist_error_code ec = ERR_NONE;
+
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		group_tenants[groupID] = tenant;
+
+		uint16_t quota = get_tenant_quota(tenant);
+		uint16_t num_held_workers = tenant_workers[tenant];
+		uint16_t num_idle_workers = (uint16_t) unallocated_workers.size();
+
+		// Workers wanted by queued requests are not given to newcomers
+		num_available_workers = queued_requests.empty() ? num_idle_workers : 0;
+
+		if (num_requested_workers > quota) ec = ERR_QUOTA_EXCEEDED;
+		else if (timeout == 0) {
+			if (num_held_workers >= quota) ec = ERR_QUOTA_EXCEEDED;
+			else if (num_available_workers == 0) ec = ERR_NO_WORKERS;
+			else num_available_workers = std::min(num_available_workers, (uint16_t) (quota - num_held_workers));
+		}
+		else if (num_available_workers < num_requested_workers || num_held_workers + num_requested_workers > quota) {
+			uint64_t sequence = next_request_sequence++;
+
+			auto timer = std::make_shared<asio::steady_timer>(ic, std::chrono::milliseconds(timeout));
+			timer->async_wait([this, sequence, timer](const error_code & timer_ec) {
+				if (!timer_ec) expire_request(sequence);
+			});
+
+			queued_requests.push_back(WorkerRequest{sequence, groupID, tenant, num_requested_workers, policy, priority, timer, handler});
+
+			log->info("Queued request of group {} for {} workers ({} requests waiting)", groupID, num_requested_workers, queued_requests.size());
+
+			return false;
+		}
+	}
+
+	if (ec == ERR_NONE) allocate_workers(groupID, std::min(num_requested_workers, num_available_workers), policy);
+	else log->info("Request of group {} for {} workers refused: {}", groupID, num_requested_workers, get_error_name(ec));
+
+	handler(ec);
+
+	return true;
+}
+
+// Waiting requests are served strictly in order: if the best request cannot get all its workers yet, later requests have
+// to wait as well, so that large requests are not starved by a stream of small ones. Requests that are over their
+// tenant's quota are passed over until the tenant gives back workers.
+void Driver::serve_queued_requests()
+{
+	while (true) {
+		WorkerRequest request;
+
+		{
+			std::lock_guard<std::mutex> lock(worker_mutex);
+
+			auto best = queued_requests.end();
+			for (auto it = queued_requests.begin(); it != queued_requests.end(); it++) {
+				if (tenant_workers[it->tenant] + it->num_workers > get_tenant_quota(it->tenant)) continue;
+
+				if (best == queued_requests.end() || it->priority > best->priority ||
+						(it->priority == best->priority && tenant_workers[it->tenant] < tenant_workers[best->tenant]))
+					best = it;
+			}
+
+			if (best == queued_requests.end() || best->num_workers > unallocated_workers.size()) return;
+
+			request = *best;
+			queued_requests.erase(best);
+		}
+
+		request.timer->cancel();
+
+		log->info("Serving queued request of group {} for {} workers", request.groupID, request.num_workers);
+		allocate_workers(request.groupID, request.num_workers, request.policy);
+
+		request.handler(ERR_NONE);
+	}
+}
+
+void Driver::expire_request(const uint64_t sequence)
+{
+	worker_request_handler handler;
+
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		auto it = std::find_if(queued_requests.begin(), queued_requests.end(),
+				[sequence](const WorkerRequest & request) { return request.sequence == sequence; });
+		if (it == queued_requests.end()) return;
+
+		log->info("Request of group {} for {} workers timed out", it->groupID, it->num_workers);
+
+		handler = it->handler;
+		queued_requests.erase(it);
+	}
+
+	handler(ERR_REQUEST_TIMEOUT);
+
+	// The expired request may have been holding up the ones behind it
+	serve_queued_requests();
+}
+
 vector<WorkerInfo_ptr> Driver::get_all_workers()
 {
 	vector<WorkerInfo_ptr> all_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	for (auto it = workers.begin(); it != workers.end(); it++)
 		all_workers.push_back(it->second);
 
@@ -352,6 +741,8 @@ vector<WorkerInfo_ptr> Driver::get_active_workers()
 {
 	vector<WorkerInfo_ptr> active_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	for (auto it = workers.begin(); it != workers.end(); it++)
 		if (it->second->groupID > 0) active_workers.push_back(it->second);
 
@@ -362,6 +753,8 @@ vector<WorkerInfo_ptr> Driver::get_inactive_workers()
 {
 	vector<WorkerInfo_ptr> inactive_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	for (auto it = workers.begin(); it != workers.end(); it++)
 		if (it->second->groupID == 0) inactive_workers.push_back(it->second);
 
@@ -372,6 +765,8 @@ vector<WorkerInfo_ptr> Driver::get_assigned_workers(const GroupID groupID)
 {
 	vector<WorkerInfo_ptr> assigned_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	for (auto it = workers.begin(); it != workers.end(); it++)
 		if (it->second->groupID == groupID) assigned_workers.push_back(it->second);
 
@@ -381,6 +776,8 @@ vector<WorkerInfo_ptr> Driver::get_assigned_workers(const GroupID groupID)
 string Driver::list_all_workers(const string & preamble)
 {
 	std::stringstream all_workers;
+
+	std::lock_guard<std::mutex> lock(worker_mutex);
 	auto num_workers = workers.size();
 
 	string sp = SPACE;
@@ -409,6 +806,8 @@ string Driver::list_active_workers(const string & preamble)
 {
 	std::stringstream active_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	auto num_active_workers = workers.size() - unallocated_workers.size();
 
 	string sp = SPACE;
@@ -439,6 +838,8 @@ string Driver::list_inactive_workers(const string & preamble)
 {
 	std::stringstream inactive_workers;
 
+	std::lock_guard<std::mutex> lock(worker_mutex);
+
 	auto num_inactive_worker = unallocated_workers.size();
 
 	string sp = SPACE;
@@ -468,6 +869,8 @@ string Driver::list_inactive_workers()
 string Driver::list_allocated_workers(const GroupID groupID, const string & preamble)
 {
 	std::stringstream allocated_workers;
+
+	std::lock_guard<std::mutex> lock(worker_mutex);
 	auto num_group_workers = groups[groupID]->workers.size();
 
 	string sp = SPACE;
@@ -605,17 +1008,26 @@ int Driver::get_num_sessions()
 void Driver::new_group(tcp::socket socket)
 {
 	log->info("NEW GROUP");
-	next_groupID++;
-	auto group_ptr = std::make_shared<GroupDriver>(next_groupID, *this, log);
-	groups.insert(std::make_pair(next_groupID, group_ptr));
-	groups[next_groupID]->start(std::move(socket));
-}
 
+	GroupDriver_ptr group_ptr;
+
+	{
+		std::lock_guard<std::mutex> lock(worker_mutex);
+
+		next_groupID++;
+		group_ptr = std::make_shared<GroupDriver>(next_groupID, *this, log);
+		groups.insert(std::make_pair(next_groupID, group_ptr));
+	}
+
+	group_ptr->start(std::move(socket));
+}
 
+// Every connection, and so every group, gets its own strand: the handlers of one group run one at a time, in order,
+// while those of other groups run on the other threads of the pool
 int Driver::accept_connection()
 {
 	if (groups.size() == 0) log->info("Accepting connections ...");
-	acceptor.async_accept(
+	acceptor.async_accept(asio::make_strand(ic),
 		[this](error_code ec, tcp::socket socket)
 		{
 //			if (!ec) std::make_shared<DriverSession>(std::move(socket), *this, next_sessionID++, log)->start();
@@ -624,9 +1036,35 @@ int Driver::accept_connection()
 			accept_connection();
 		});
 
+	return 0;
+}
+
+// A long task of one group (which blocks a thread until the workers are done) then does not hold up the other groups.
+// Groups use their own communicators, but several threads making MPI calls at once needs MPI_THREAD_MULTIPLE; without
+// it the driver falls back to a single thread.
+void Driver::run_io_threads()
+{
+	unsigned int num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	const char * driver_threads = std::getenv("ALCHEMIST_DRIVER_THREADS");
+	if (driver_threads != nullptr && std::atoi(driver_threads) > 0) num_threads = (unsigned int) std::atoi(driver_threads);
+
+	int provided;
+	MPI_Query_thread(&provided);
+	if (provided < MPI_THREAD_MULTIPLE && num_threads > 1) {
+		log->warn("MPI does not provide MPI_THREAD_MULTIPLE, groups will be served by a single thread");
+		num_threads = 1;
+	}
+
+	log->info("Serving groups with {} threads", num_threads);
+
+	vector<std::thread> io_threads;
+	for (unsigned int i = 1; i < num_threads; i++)
+		io_threads.push_back(std::thread([this]() { ic.run(); }));
+
 	ic.run();
 
-	return 0;
+	for (auto & t: io_threads) t.join();
 }
 
 // ===============================================================================================
@@ -23,8 +23,27 @@ public:
 
 	// -----------------------------------------   Workers   -----------------------------------------
 
-	uint16_t allocate_workers(const GroupID groupID, const uint16_t & num_requested_workers);
+	// Picks the given number of workers out of the available ones (sorted by ID)
+	typedef std::function<vector<WorkerID>(const vector<WorkerInfo_ptr> &, const uint16_t)> allocation_function;
+
+	void set_allocation_policy(const allocation_policy policy, allocation_function f);
+
+	uint16_t allocate_workers(const GroupID groupID, const uint16_t & num_requested_workers, const allocation_policy policy = ALLOCATE_IN_ORDER);
 	vector<WorkerID> deallocate_workers(const GroupID groupID, const vector<WorkerID> & selected_workers);
+	void release_group(const GroupID groupID);
+
+	// Called with ERR_NONE once the workers have been allocated to the group, or with the reason they were not
+	typedef std::function<void(const alchemist_error_code)> worker_request_handler;
+
+	// Admission control for the workers requested by clients. Tenants (identified by the address of the client) may
+	// hold at most their quota of workers. Without a timeout a request is answered right away with as many workers as
+	// can be given; with a timeout (in milliseconds) it waits in the queue for all the requested workers. Queued
+	// requests are served by priority, then to the tenant holding the fewest workers, then in order of arrival.
+	// Returns false if the request was queued, in which case the handler is called later.
+	bool request_workers(const GroupID groupID, const string & tenant, const uint16_t num_requested_workers, const allocation_policy policy,
+			const uint8_t priority, const uint32_t timeout, worker_request_handler handler);
+
+	void set_tenant_quota(const string & tenant, const uint16_t max_workers);
 
 	vector<WorkerInfo_ptr> get_all_workers();
 	vector<WorkerInfo_ptr> get_active_workers();
@@ -55,6 +74,12 @@ public:
 
 	uint16_t get_num_workers();
 
+	// In coordinator-only mode libraries are not loaded on the driver and tasks run on the workers alone
+	bool is_coordinator_only() const { return coordinator_only; }
+
+	// Libraries need not be thread-safe, so the driver's part of a task runs for one group at a time
+	std::mutex & get_library_mutex() { return library_mutex; }
+
 	int load_library(string library_name, string library_path);
 
 //	vector<vector<uint32_t> > new_matrix(unsigned char type, unsigned char layout, uint32_t num_rows, uint32_t num_cols);
@@ -64,8 +89,12 @@ public:
 
 private:
 	MPI_Comm world;
+	MPI_Comm control;					// For messages between the driver and single workers, such as new groups
 
 	std::mutex worker_mutex;			// For safe access during worker allocation
+	std::mutex library_mutex;			// For running libraries on the driver
+
+	bool coordinator_only;
 
 	GroupID next_groupID;
 
@@ -96,15 +125,48 @@ private:
 
 	void set_group_communicator(const GroupID & groupID);
 
+	// Communicators of earlier groups, keyed by their (sorted) workers, so that a group that is formed again with the
+	// same workers does not have to create a new one. These communicators are never freed.
+	enum { max_cached_group_comms = 64 };
+	map<vector<WorkerID>, MPI_Comm> group_comms;
+
 	// -----------------------------------------   Workers   -----------------------------------------
 
 	uint16_t num_workers;
 
 	map<WorkerID, WorkerInfo_ptr> workers;
+	map<allocation_policy, allocation_function> allocation_policies;
+
+	void register_allocation_policies();
 
 	map<GroupID, map<WorkerID, WorkerInfo_ptr> > allocated_workers;
 	vector<WorkerID> unallocated_workers;
 
+	// ------------------------------------   Admission Control   ------------------------------------
+
+	struct WorkerRequest {
+		uint64_t sequence;
+		GroupID groupID;
+		string tenant;
+		uint16_t num_workers;
+		allocation_policy policy;
+		uint8_t priority;
+		std::shared_ptr<asio::steady_timer> timer;
+		worker_request_handler handler;
+	};
+
+	std::list<WorkerRequest> queued_requests;
+	uint64_t next_request_sequence;
+
+	uint16_t default_tenant_quota;
+	map<string, uint16_t> tenant_quotas;
+	map<string, uint16_t> tenant_workers;				// Number of workers held by each tenant
+	map<GroupID, string> group_tenants;
+
+	uint16_t get_tenant_quota(const string & tenant) const;
+	void serve_queued_requests();
+	void expire_request(const uint64_t sequence);
+
 	int start_workers();
 	int register_workers();
 
@@ -144,6 +206,7 @@ private:
 
 	int start_new_session();
 	int accept_connection();
+	void run_io_threads();
 };
 
 }
@@ -7,13 +7,13 @@ namespace alchemist {
 // =============================================================================================
 
 DriverSession::DriverSession(tcp::socket _socket, GroupDriver & _group_driver) :
-		Session(std::move(_socket)), group_driver(_group_driver), num_group_workers(0) { }
+		Session(std::move(_socket)), group_driver(_group_driver), num_group_workers(0), waiting_for_workers(false) { }
 
 DriverSession::DriverSession(tcp::socket _socket, GroupDriver & _group_driver, ClientID _clientID) :
-		Session(std::move(_socket), 0, _clientID), group_driver(_group_driver), num_group_workers(0) { }
+		Session(std::move(_socket), 0, _clientID), group_driver(_group_driver), num_group_workers(0), waiting_for_workers(false) { }
 
 DriverSession::DriverSession(tcp::socket _socket, GroupDriver & _group_driver, ClientID _clientID, Log_ptr & _log) :
-		Session(std::move(_socket), 0, _clientID, _log), group_driver(_group_driver), num_group_workers(0) { }
+		Session(std::move(_socket), 0, _clientID, _log), group_driver(_group_driver), num_group_workers(0), waiting_for_workers(false) { }
 
 void DriverSession::start()
 {
@@ -62,7 +62,7 @@ int DriverSession::handle_message()
 					break;
 				// Workers
 				case REQUEST_WORKERS:
-					handle_request_workers();
+					if (!handle_request_workers()) return 0;
 					break;
 				case YIELD_WORKERS:
 					handle_yield_workers();
@@ -105,10 +105,47 @@ int DriverSession::handle_message()
 				case REQUEST_MATRIX_BLOCKS:
 					handle_request_matrix_blocks();
 					break;
+				case LOAD_MATRIX_FILE:
+					handle_load_matrix_file();
+					break;
+				case SAVE_MATRIX:
+					handle_save_matrix();
+					break;
+				case SAVE_SNAPSHOT:
+					handle_save_snapshot();
+					break;
+				case LOAD_SNAPSHOT:
+					handle_load_snapshot();
+					break;
 					// Tasks
 				case RUN_TASK:
 					handle_run_task();
 					break;
+					// Built-in operations
+				case MATRIX_TRANSPOSE:
+					handle_matrix_transpose();
+					break;
+				case MATRIX_MULTIPLY:
+					handle_matrix_multiply();
+					break;
+				case MATRIX_ROWS:
+					handle_matrix_rows();
+					break;
+				case MATRIX_DIMENSIONS:
+					handle_matrix_dimensions();
+					break;
+				case MATRIX_VIEW:
+					handle_matrix_view();
+					break;
+				case MATRIX_EXPRESSION:
+					handle_matrix_expression();
+					break;
+				case MATRIX_STATS:
+					handle_matrix_stats();
+					break;
+				case GENERATE_MATRIX:
+					handle_generate_matrix();
+					break;
 				default:
 					handle_invalid_command();
 					break;
@@ -173,26 +210,53 @@ void DriverSession::handle_close_connection()
 
 }
 
-void DriverSession::handle_request_workers()
+// Returns false if the request has to wait for workers, in which case the reply is sent (and reading resumes) later
+bool DriverSession::handle_request_workers()
 {
 	uint16_t num_requested_workers = read_msg.read_uint16();
 
-	write_msg.start(clientID, sessionID, REQUEST_WORKERS);
+	// Optional hint for how the workers should be picked, the request's priority and how long (in milliseconds) the
+	// client is willing to wait for all the workers
+	allocation_policy policy = ALLOCATE_IN_ORDER;
+	uint8_t priority = 0;
+	uint32_t timeout = 0;
+	if (!read_msg.eom()) policy = (allocation_policy) read_msg.read_uint8();
+	if (!read_msg.eom()) priority = read_msg.read_uint8();
+	if (!read_msg.eom()) timeout = read_msg.read_uint32();
+
+	if (num_requested_workers == 0) {
+		send_allocated_workers(ERR_NONPOS_WORKER_REQUEST);
+		return true;
+	}
 
-	if (num_requested_workers > 0) {
-		map<WorkerID, WorkerInfo_ptr> allocated_workers = group_driver.allocate_workers(num_requested_workers);
+	// A queued request is answered from whichever thread frees the workers (or from its timer), so the reply is
+	// always handed to this session's strand; it runs after this handler, once waiting_for_workers has been set
+	auto self(shared_from_this());
+	waiting_for_workers = !group_driver.request_workers(num_requested_workers, policy, priority, timeout,
+			[this, self](const alchemist_error_code ec) {
+		asio::post(socket.get_executor(), [this, self, ec]() {
+			send_allocated_workers(ec);
+			if (waiting_for_workers) {
+				waiting_for_workers = false;
+				read_header();
+			}
+		});
+	});
 
-		if (allocated_workers.size() > 0) {
-			uint16_t num_allocated_workers = allocated_workers.size();
-			write_msg.write_uint16(num_allocated_workers);
-			for (auto it = allocated_workers.begin(); it != allocated_workers.end(); it++)
-				write_msg.write_WorkerInfo(it->second);
-		}
-		else write_msg.write_error_code(ERR_NO_WORKERS);
-	}
-	else {
-		write_msg.write_error_code(ERR_NONPOS_WORKER_REQUEST);
+	return !waiting_for_workers;
+}
+
+void DriverSession::send_allocated_workers(const alchemist_error_code ec)
+{
+	write_msg.start(clientID, sessionID, REQUEST_WORKERS);
+
+	if (ec == ERR_NONE && group_driver.workers.size() > 0) {
+		uint16_t num_allocated_workers = group_driver.workers.size();
+		write_msg.write_uint16(num_allocated_workers);
+		for (auto it = group_driver.workers.begin(); it != group_driver.workers.end(); it++)
+			write_msg.write_WorkerInfo(it->second);
 	}
+	else write_msg.write_error_code((ec == ERR_NONE) ? ERR_NO_WORKERS : ec);
 
 	flush();
 }
@@ -200,7 +264,6 @@ void DriverSession::handle_request_workers()
 void DriverSession::handle_yield_workers()
 {
 	vector<WorkerID> yielded_workers;
-	WorkerID workerID;
 	map<WorkerID, WorkerInfo_ptr>::iterator it;
 
 	write_msg.start(clientID, sessionID, YIELD_WORKERS);
@@ -210,8 +273,15 @@ void DriverSession::handle_yield_workers()
 			yielded_workers.push_back(it->first);
 	}
 	else {
-		while (!read_msg.eom()) {
-			workerID = read_msg.read_uint16();
+		vector<WorkerID> requested_workers;
+		datatype dt = read_msg.preview_datatype();
+		if (dt == UINT16_ARRAY || dt == INT16_ARRAY) requested_workers = read_msg.read_uint16_array();
+		else {
+			// Older clients send the worker IDs one at a time
+			while (!read_msg.eom()) requested_workers.push_back(read_msg.read_uint16());
+		}
+
+		for (WorkerID workerID : requested_workers) {
 			it = group_driver.workers.find(workerID);
 			if (it != group_driver.workers.end()) {
 				yielded_workers.push_back(workerID);
@@ -221,8 +291,7 @@ void DriverSession::handle_yield_workers()
 
 	if (yielded_workers.size() != 0) {
 		vector<WorkerID> deallocated_workers = group_driver.deallocate_workers(yielded_workers);
-		for (auto it = deallocated_workers.begin(); it < deallocated_workers.end(); it++)
-			write_msg.write_uint16(*it);
+		write_msg.write_uint16_array(deallocated_workers);
 	}
 
 	flush();
@@ -426,6 +495,166 @@ void DriverSession::handle_unload_library()
 //	unload_library();
 }
 
+void DriverSession::handle_load_matrix_file()
+{
+	string file_name = read_msg.read_string();
+	// Only HDF5 files need a dataset name, and only raw files the number of columns; the format is otherwise taken
+	// from the file itself or its extension
+	string dataset_name = read_msg.eom() ? string("") : read_msg.read_string();
+	uint8_t format = read_msg.eom() ? AUTO_FORMAT : read_msg.read_uint8();
+	uint64_t num_cols = read_msg.eom() ? 0 : read_msg.read_uint64();
+
+	ArrayID matrixID = group_driver.load_matrix_file(file_name, dataset_name, format, num_cols);
+
+	write_msg.start(clientID, sessionID, LOAD_MATRIX_FILE);
+	if (matrixID > 0) write_msg.write_ArrayInfo(group_driver.get_matrix_info(matrixID));
+	else write_msg.write_error_code(ERR_FILE_ACCESS);
+	flush();
+}
+
+void DriverSession::handle_save_matrix()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+	string file_name = read_msg.read_string();
+
+	write_msg.start(clientID, sessionID, SAVE_MATRIX);
+	if (group_driver.save_matrix(matrixID, file_name)) write_msg.write_ArrayID(matrixID);
+	else write_msg.write_error_code(ERR_FILE_ACCESS);
+	flush();
+}
+
+void DriverSession::handle_save_snapshot()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+	string path = read_msg.read_string();
+
+	write_msg.start(clientID, sessionID, SAVE_SNAPSHOT);
+	if (group_driver.save_snapshot(matrixID, path)) write_msg.write_ArrayID(matrixID);
+	else write_msg.write_error_code(ERR_FILE_ACCESS);
+	flush();
+}
+
+void DriverSession::handle_load_snapshot()
+{
+	string path = read_msg.read_string();
+
+	ArrayID matrixID = group_driver.load_snapshot(path);
+
+	write_msg.start(clientID, sessionID, LOAD_SNAPSHOT);
+	if (matrixID > 0) write_msg.write_ArrayInfo(group_driver.get_matrix_info(matrixID));
+	else write_msg.write_error_code(ERR_FILE_ACCESS);
+	flush();
+}
+
+void DriverSession::handle_matrix_transpose()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(MATRIX_TRANSPOSE, group_driver.get_transpose(matrixID, ec), ec);
+}
+
+void DriverSession::handle_matrix_multiply()
+{
+	ArrayID matrixID_A = read_msg.read_ArrayID();
+	ArrayID matrixID_B = read_msg.read_ArrayID();
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(MATRIX_MULTIPLY, group_driver.matrix_multiply(matrixID_A, matrixID_B, ec), ec);
+}
+
+void DriverSession::handle_matrix_rows()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+
+	// Rows to extract, in the order they should appear in the result
+	vector<uint64_t> rows;
+	while (!read_msg.eom()) rows.push_back(read_msg.read_uint64());
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(MATRIX_ROWS, group_driver.get_matrix_rows(matrixID, rows, ec), ec);
+}
+
+void DriverSession::handle_matrix_dimensions()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+
+	write_msg.start(clientID, sessionID, MATRIX_DIMENSIONS);
+	if (group_driver.has_matrix(matrixID)) write_msg.write_ArrayInfo(group_driver.get_matrix_info(matrixID));
+	else write_msg.write_error_code(ERR_INVALID_MATRIX);
+	flush();
+}
+
+void DriverSession::handle_matrix_view()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+
+	// Start, end and stride of the rows and then the columns, followed by whether to transpose
+	uint64_t dims[6];
+	for (int k = 0; k < 6; k++) dims[k] = read_msg.read_uint64();
+	bool transposed = read_msg.eom() ? false : (read_msg.read_uint8() != 0);
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(MATRIX_VIEW, group_driver.create_view(matrixID, dims, transposed, ec), ec);
+}
+
+void DriverSession::handle_matrix_expression()
+{
+	// Matrix to write the result into (0 for a new one), the expression, and then its operands
+	ArrayID targetID = read_msg.read_ArrayID();
+	string expression = read_msg.read_string();
+
+	vector<ArrayID> operandIDs;
+	while (!read_msg.eom()) operandIDs.push_back(read_msg.read_ArrayID());
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(MATRIX_EXPRESSION, group_driver.evaluate_expression(expression, operandIDs, targetID, ec), ec);
+}
+
+void DriverSession::handle_matrix_stats()
+{
+	ArrayID matrixID = read_msg.read_ArrayID();
+
+	Parameters stats;
+	alchemist_error_code ec = ERR_NONE;
+
+	write_msg.start(clientID, sessionID, MATRIX_STATS);
+	if (group_driver.get_matrix_stats(matrixID, stats, ec)) {
+		write_msg.write_ArrayID(matrixID);
+		group_driver.serialize_parameters(stats, write_msg);
+	}
+	else write_msg.write_error_code(ec);
+	flush();
+}
+
+void DriverSession::handle_generate_matrix()
+{
+	// Dimensions, distribution and seed, optionally followed by the distribution's parameters
+	uint64_t num_rows = read_msg.read_uint64();
+	uint64_t num_cols = read_msg.read_uint64();
+	random_distribution dist = (random_distribution) read_msg.read_uint8();
+	uint64_t seed = read_msg.read_uint64();
+
+	double params[2] = {0.0, 1.0};
+	if (dist == SPARSE_SIGN_DISTRIBUTION) params[0] = 1.0/3.0;
+	if (!read_msg.eom()) params[0] = read_msg.read_double();
+	if (!read_msg.eom()) params[1] = read_msg.read_double();
+
+	alchemist_error_code ec = ERR_NONE;
+	send_matrix_result(GENERATE_MATRIX, group_driver.generate_matrix(num_rows, num_cols, dist, seed, params, ec), ec);
+}
+
+void DriverSession::send_matrix_result(client_command command, ArrayID matrixID, alchemist_error_code ec)
+{
+	write_msg.start(clientID, sessionID, command);
+	if (matrixID > 0) write_msg.write_ArrayInfo(group_driver.get_matrix_info(matrixID));
+	else {
+		log->info("{} {} failed: {}", preamble(), get_command_name(command), get_error_name(ec));
+		write_msg.write_error_code(ec);
+	}
+	flush();
+}
+
 void DriverSession::handle_matrix_info()
 {
 	ArrayInfo_ptr x = read_msg.read_ArrayInfo();
@@ -537,6 +766,9 @@ void DriverSession::request_matrix()
 void DriverSession::remove_session()
 {
 //	driver.remove_session();
+
+	// Workers of a client that has gone are not coming back otherwise
+	group_driver.release_workers();
 }
 
 void DriverSession::send_matrix_info(ArrayID matrixID)
@@ -551,19 +783,13 @@ void DriverSession::send_matrix_info(ArrayID matrixID)
 void DriverSession::send_layout(vector<vector<uint32_t> > & rows_on_workers)
 {
 	uint16_t num_workers = rows_on_workers.size();
-	uint32_t worker_num_rows, row;
 
 	write_msg.start(clientID, sessionID, SEND_MATRIX_LAYOUT);
 	write_msg.write_uint16(num_workers);
 
 	for (uint16_t i = 0; i < num_workers; i++) {
 		write_msg.write_uint16(i);
-		worker_num_rows = rows_on_workers[i].size();
-		write_msg.write_uint32(worker_num_rows);
-		for (uint32_t j = 0; j < worker_num_rows; j++) {
-			row = rows_on_workers[i][j];
-			write_msg.write_uint32(row);
-		}
+		write_msg.write_uint32_array(rows_on_workers[i]);
 	}
 
 	flush();
@@ -571,14 +797,8 @@ void DriverSession::send_layout(vector<vector<uint32_t> > & rows_on_workers)
 
 void DriverSession::send_layout(vector<uint16_t> & row_assignments)
 {
-	uint32_t num_rows = row_assignments.size();
-	uint16_t worker;
-
 	write_msg.start(clientID, sessionID, SEND_MATRIX_LAYOUT);
-	write_msg.write_uint32(num_rows);
-
-	for (uint32_t row = 0; row < num_rows; row++)
-		write_msg.write_uint16(row_assignments[row]);
+	write_msg.write_uint16_array(row_assignments);
 
 	flush();
 }
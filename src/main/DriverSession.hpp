@@ -46,13 +46,16 @@ private:
 	uint16_t num_group_workers;
 	string log_dir;
 
+	bool waiting_for_workers;			// The session stops reading messages while its request for workers is queued
+
 //	void handle_handshake();
 	void handle_request_ID();
 	void handle_client_info();
 	void handle_send_test_string();
 	void handle_request_test_string();
 	void handle_close_connection();
-	void handle_request_workers();
+	bool handle_request_workers();
+	void send_allocated_workers(const alchemist_error_code ec);
 	void handle_yield_workers();
 	void handle_send_assigned_worker_info();
 	void handle_list_all_workers();
@@ -66,12 +69,25 @@ private:
 	void handle_matrix_layout();
 	void handle_send_matrix_blocks();
 	void handle_request_matrix_blocks();
+	void handle_load_matrix_file();
+	void handle_save_matrix();
+	void handle_save_snapshot();
+	void handle_load_snapshot();
 	void handle_run_task();
+	void handle_matrix_transpose();
+	void handle_matrix_multiply();
+	void handle_matrix_rows();
+	void handle_matrix_dimensions();
+	void handle_matrix_view();
+	void handle_matrix_expression();
+	void handle_matrix_stats();
+	void handle_generate_matrix();
 	void handle_invalid_command();
 	void handle_shutdown();
 
 	void send_layout(vector<vector<uint32_t> > & rows_on_workers);
 	void send_layout(vector<uint16_t> & row_assignments);
+	void send_matrix_result(client_command command, ArrayID matrixID, alchemist_error_code ec);
 
 };
 
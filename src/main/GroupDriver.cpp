@@ -5,9 +5,9 @@ namespace alchemist {
 // ===============================================================================================
 // =======================================   CONSTRUCTOR   =======================================
 
-GroupDriver::GroupDriver(GroupID ID, Driver & _driver): ID(ID), driver(_driver), group(MPI_COMM_NULL), cl(SCALA), next_matrixID(1), next_libraryID(2) { }
+GroupDriver::GroupDriver(GroupID ID, Driver & _driver): ID(ID), driver(_driver), group(MPI_COMM_NULL), group_comm_cached(false), cl(SCALA), next_matrixID(1), next_libraryID(2) { }
 
-GroupDriver::GroupDriver(GroupID ID, Driver & _driver, Log_ptr & _log): ID(ID), driver(_driver), group(MPI_COMM_NULL),
+GroupDriver::GroupDriver(GroupID ID, Driver & _driver, Log_ptr & _log): ID(ID), driver(_driver), group(MPI_COMM_NULL), group_comm_cached(false),
 		log(_log), cl(SCALA), next_matrixID(1), next_libraryID(2) { }
 
 GroupDriver::~GroupDriver() { }
@@ -74,8 +74,11 @@ void GroupDriver::free_group()
 		MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
 		MPI_Wait(&req, &status);
 
-		MPI_Barrier(group);
-		MPI_Comm_free(&group);
+		// Communicators in the driver's cache stay around for the next group with the same workers
+		if (!group_comm_cached) {
+			MPI_Barrier(group);
+			MPI_Comm_free(&group);
+		}
 		group = MPI_COMM_NULL;
 	}
 }
@@ -94,9 +97,9 @@ void GroupDriver::print_info()
 	MPI_Barrier(group);
 }
 
-const map<WorkerID, WorkerInfo_ptr> & GroupDriver::allocate_workers(const uint16_t & num_requested_workers)
+const map<WorkerID, WorkerInfo_ptr> & GroupDriver::allocate_workers(const uint16_t & num_requested_workers, const allocation_policy policy)
 {
-	driver.allocate_workers(ID, num_requested_workers);
+	driver.allocate_workers(ID, num_requested_workers, policy);
 
 	return workers;
 }
@@ -106,6 +109,18 @@ vector<WorkerID> GroupDriver::deallocate_workers(const vector<WorkerID> & yielde
 	return driver.deallocate_workers(ID, yielded_workers);
 }
 
+void GroupDriver::release_workers()
+{
+	driver.release_group(ID);
+}
+
+// The client's address identifies the tenant the group belongs to
+bool GroupDriver::request_workers(const uint16_t num_requested_workers, const allocation_policy policy, const uint8_t priority, const uint32_t timeout,
+		std::function<void(const alchemist_error_code)> handler)
+{
+	return driver.request_workers(ID, session->get_address(), num_requested_workers, policy, priority, timeout, handler);
+}
+
 uint16_t GroupDriver::get_num_workers()
 {
 	return (uint16_t) workers.size();
@@ -121,12 +136,69 @@ uint64_t GroupDriver::get_num_cols(ArrayID & matrixID)
 	return matrices[matrixID]->num_cols;
 }
 
-void GroupDriver::set_group_comm(MPI_Comm & world, MPI_Group & temp_group)
+void GroupDriver::set_group_comm(MPI_Comm & world, MPI_Group & temp_group, bool cached)
 {
 	log->info("Creating new group");
-	MPI_Comm_create_group(world, temp_group, 0, &group);
+	MPI_Comm_create_group(world, temp_group, ID, &group);
 	MPI_Barrier(group);
 
+	group_comm_cached = cached;
+}
+
+void GroupDriver::reuse_group_comm(const MPI_Comm & cached_group)
+{
+	group = cached_group;
+	group_comm_cached = true;
+}
+
+const MPI_Comm & GroupDriver::get_group_comm() const
+{
+	return group;
+}
+
+// Moves the rows of the group's matrices from the workers the group was formed with before to its current workers; the
+// handover communicator has the driver as rank 0 followed by the (sorted) union of both sets of workers. The driver
+// only sends the matrices to be moved and records their new layouts, see GroupWorker::redistribute_matrices.
+void GroupDriver::redistribute_matrices(MPI_Comm & handover, const vector<WorkerID> & handover_workers)
+{
+	log->info("Redistributing {} matrices over {} workers", matrices.size(), workers.size());
+
+	std::clock_t start = std::clock();
+
+	int handover_size = (int) handover_workers.size() + 1;
+
+	uint32_t num_matrices = (uint32_t) matrices.size();
+	vector<uint64_t> specs;
+	for (auto it = matrices.begin(); it != matrices.end(); it++) {
+		specs.push_back(it->first);
+		specs.push_back(it->second->num_rows);
+		specs.push_back(it->second->num_cols);
+	}
+
+	MPI_Bcast(&num_matrices, 1, MPI_UNSIGNED, 0, handover);
+	MPI_Bcast(specs.data(), (int) specs.size(), MPI_UNSIGNED_LONG, 0, handover);
+
+	int shifts[3] = {-1, 0, -1};
+	vector<int> all_shifts(3*handover_size);
+	vector<int> no_data(handover_size, 0);
+	double no_buffer;
+
+	for (auto it = matrices.begin(); it != matrices.end(); it++) {
+		MPI_Allgather(shifts, 3, MPI_INT, all_shifts.data(), 3, MPI_INT, handover);
+
+		// Row i of a [VR,STAR] matrix belongs to the worker whose column shift is i modulo the number of workers
+		vector<WorkerID> owners(workers.size());
+		for (int r = 1; r < handover_size; r++)
+			if (all_shifts[3*r+2] >= 0) owners[all_shifts[3*r+2]] = handover_workers[r-1];
+
+		MPI_Alltoallv(&no_buffer, no_data.data(), no_data.data(), MPI_DOUBLE, &no_buffer, no_data.data(), no_data.data(), MPI_DOUBLE, handover);
+
+		ArrayInfo_ptr x = it->second;
+		for (uint64_t i = 0; i < x->num_rows; i++) x->worker_assignments[i] = owners[i % owners.size()];
+		x->num_partitions = (uint8_t) owners.size();
+	}
+
+	log->info("Redistributing matrices took {}ms", 1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
 }
 
 void GroupDriver::ready_group()
@@ -207,8 +279,19 @@ LibraryID GroupDriver::load_library(string library_name, string library_path)
 	MPI_Bcast(&library_path_c_length, 1, MPI_UNSIGNED_SHORT, 0, group);
 	MPI_Bcast(library_path_c, library_path_length+1, MPI_CHAR, 0, group);
 
+	// Workers create the library on their own communicator if the driver does not take part in tasks
+	uint8_t workers_only = driver.is_coordinator_only() ? 1 : 0;
+	MPI_Bcast(&workers_only, 1, MPI_UNSIGNED_CHAR, 0, group);
+
 	MPI_Barrier(group);
 
+	if (workers_only) {
+		log->info("Library {} is only loaded on the workers", library_name);
+		MPI_Barrier(group);
+
+		return next_libraryID;
+	}
+
 	char cstr[library_path.length()+1];
 	std::strcpy(cstr, library_path.c_str());
 
@@ -232,11 +315,15 @@ LibraryID GroupDriver::load_library(string library_name, string library_path)
 		return 0;
 	}
 
-	Library * library_ptr = reinterpret_cast<Library*>(create_library(group));
+	{
+		std::lock_guard<std::mutex> lock(driver.get_library_mutex());
 
-	libraries.insert(std::make_pair(next_libraryID, library_ptr));
+		Library * library_ptr = reinterpret_cast<Library*>(create_library(group));
 
-	library_ptr->load();
+		libraries.insert(std::make_pair(next_libraryID, library_ptr));
+
+		library_ptr->load();
+	}
 
 	delete dlsym_error;
 
@@ -266,25 +353,28 @@ void GroupDriver::run_task(Message & in_msg, Message & out_msg)
 	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
 	MPI_Wait(&req, &status);
 
-	uint32_t in_data_length = in_msg.get_body_length();
+	bool workers_only = driver.is_coordinator_only();
 
-	MPI_Bcast(&in_data_length, 1, MPI_UNSIGNED, 0, group);
-	MPI_Bcast(in_msg.body(), in_data_length, MPI_CHAR, 0, group);
+	// Body length, followed by what the workers need to parse the body the same way as the driver, and whether the
+	// driver takes part in the task
+	uint32_t task_header[5] = {(uint32_t) in_msg.get_body_length(), (uint32_t) in_msg.cl, in_msg.reverse_floats, in_msg.little_endian, workers_only};
 
-	MPI_Barrier(group);
+	MPI_Bcast(task_header, 5, MPI_UNSIGNED, 0, group);
+	MPI_Bcast(in_msg.body(), task_header[0], MPI_CHAR, 0, group);
 
 	Parameters in, out;
 
-	MPI_Barrier(group);
-
 	LibraryID libID = in_msg.read_LibraryID();
 
 	if (check_libraryID(libID)) {
-		string function_name = in_msg.read_string();
+		if (!workers_only) {
+			string function_name = in_msg.read_string();
 
-		deserialize_parameters(in, in_msg);
+			deserialize_parameters(in, in_msg);
 
-		libraries[libID]->run(function_name, in, out);
+			std::lock_guard<std::mutex> lock(driver.get_library_mutex());
+			libraries[libID]->run(function_name, in, out);
+		}
 
 		MPI_Barrier(group);
 
@@ -293,7 +383,8 @@ void GroupDriver::run_task(Message & in_msg, Message & out_msg)
 		uint16_t dmnl;
 		uint64_t num_rows, num_cols;
 
-		WorkerID primary_worker = workers.begin()->first;
+		// The group's workers are ranks 1, 2, ... of the group communicator, in order of their IDs
+		const int primary_worker = 1;
 
 		MPI_Recv(&num_distmatrices, 1, MPI_INT, primary_worker, 0, group, &status);
 
@@ -328,14 +419,15 @@ void GroupDriver::run_task(Message & in_msg, Message & out_msg)
 				MPI_Bcast(&matrixIDs[i], 1, MPI_UNSIGNED_SHORT, 0, group);
 				MPI_Barrier(group);
 
-				for (auto it = workers.begin(); it != workers.end(); it++) {
+				int rank = 1;
+				for (auto it = workers.begin(); it != workers.end(); it++, rank++) {
 
 					WorkerID id = it->first;
-					MPI_Recv(&worker_num_rows, 1, MPI_UNSIGNED_LONG, id, 0, group, &status);
+					MPI_Recv(&worker_num_rows, 1, MPI_UNSIGNED_LONG, rank, 0, group, &status);
 
 					row_indices = new uint64_t[worker_num_rows];
 
-					MPI_Recv(row_indices, (int) worker_num_rows, MPI_UNSIGNED_LONG, id, 0, group, &status);
+					MPI_Recv(row_indices, (int) worker_num_rows, MPI_UNSIGNED_LONG, rank, 0, group, &status);
 					for (uint64_t j = 0; j < worker_num_rows; j++)
 						matrices[matrixIDs[i]]->worker_assignments[row_indices[j]] = id;
 
@@ -347,7 +439,17 @@ void GroupDriver::run_task(Message & in_msg, Message & out_msg)
 
 		MPI_Barrier(group);
 
-		serialize_parameters(out, out_msg);
+		if (workers_only) {
+			// The output parameters come from the primary group worker, already serialized for the client
+			uint32_t output_length;
+			MPI_Recv(&output_length, 1, MPI_UNSIGNED, primary_worker, 0, group, &status);
+
+			vector<char> output(output_length);
+			MPI_Recv(output.data(), (int) output_length, MPI_CHAR, primary_worker, 0, group, &status);
+
+			out_msg.put_raw(output.data(), output_length);
+		}
+		else serialize_parameters(out, out_msg);
 	}
 
 //	out_msg.update_body_length();
@@ -356,13 +458,13 @@ void GroupDriver::run_task(Message & in_msg, Message & out_msg)
 
 void GroupDriver::deserialize_parameters(Parameters & p, Message & msg) {
 
-	string name = "";
 	datatype dt = NONE;
 	uint32_t data_length;
 	while (!msg.eom()) {
 		dt = (datatype) msg.get_datatype();
 		if (dt == PARAMETER) {
-			name = msg.read_string();
+			// The name, and the value of string and (where possible) array parameters, are views of the message
+			ParameterName name(msg.read_string_span());
 			dt = (datatype) msg.preview_datatype();
 
 			switch (dt) {
@@ -403,12 +505,78 @@ void GroupDriver::deserialize_parameters(Parameters & p, Message & msg) {
 				p.add_double(name, msg.read_double());
 				break;
 			case STRING:
-				p.add_string(name, msg.read_string());
+				p.add_string_view(name, msg.read_string_span());
 				break;
-			case ARRAY_ID:
-				p.add_matrix_info(name, matrices[msg.read_ArrayID()]);
+			case INT16_ARRAY: {
+				vector<int16_t> storage;
+				ArraySpan<int16_t> value = msg.read_int16_array_span(storage);
+				if (storage.empty()) p.add_int16_array_view(name, value);
+				else p.add_int16_array(name, value);
+				break;
+			}
+			case INT32_ARRAY: {
+				vector<int32_t> storage;
+				ArraySpan<int32_t> value = msg.read_int32_array_span(storage);
+				if (storage.empty()) p.add_int32_array_view(name, value);
+				else p.add_int32_array(name, value);
+				break;
+			}
+			case INT64_ARRAY: {
+				vector<int64_t> storage;
+				ArraySpan<int64_t> value = msg.read_int64_array_span(storage);
+				if (storage.empty()) p.add_int64_array_view(name, value);
+				else p.add_int64_array(name, value);
 				break;
 			}
+			case UINT16_ARRAY: {
+				vector<uint16_t> storage;
+				ArraySpan<uint16_t> value = msg.read_uint16_array_span(storage);
+				if (storage.empty()) p.add_uint16_array_view(name, value);
+				else p.add_uint16_array(name, value);
+				break;
+			}
+			case UINT32_ARRAY: {
+				vector<uint32_t> storage;
+				ArraySpan<uint32_t> value = msg.read_uint32_array_span(storage);
+				if (storage.empty()) p.add_uint32_array_view(name, value);
+				else p.add_uint32_array(name, value);
+				break;
+			}
+			case UINT64_ARRAY: {
+				vector<uint64_t> storage;
+				ArraySpan<uint64_t> value = msg.read_uint64_array_span(storage);
+				if (storage.empty()) p.add_uint64_array_view(name, value);
+				else p.add_uint64_array(name, value);
+				break;
+			}
+			case FLOAT_ARRAY: {
+				vector<float> storage;
+				ArraySpan<float> value = msg.read_float_array_span(storage);
+				if (storage.empty()) p.add_float_array_view(name, value);
+				else p.add_float_array(name, value);
+				break;
+			}
+			case DOUBLE_ARRAY: {
+				vector<double> storage;
+				ArraySpan<double> value = msg.read_double_array_span(storage);
+				if (storage.empty()) p.add_double_array_view(name, value);
+				else p.add_double_array(name, value);
+				break;
+			}
+			case STRING_ARRAY:
+				p.add_string_array(name, msg.read_string_array());
+				break;
+			case LOCAL_MATRIX:
+				p.add_local_matrix(name, msg.read_local_matrix());
+				break;
+			case ARRAY_ID: {
+				ArrayID matrixID = msg.read_ArrayID();
+				auto it = matrices.find(matrixID);
+				if (it != matrices.end()) p.add_matrix_info(name, it->second);
+				else log->info("Task parameter refers to unknown array {}", matrixID);
+				break;
+			}
+			}
 		}
 	}
 }
@@ -463,6 +631,36 @@ void GroupDriver::serialize_parameters(Parameters & p, Message & msg)
 		case STRING:
 			msg.write_string(p.get_string(name));
 			break;
+		case INT16_ARRAY:
+			msg.write_int16_array(p.get_int16_array(name));
+			break;
+		case INT32_ARRAY:
+			msg.write_int32_array(p.get_int32_array(name));
+			break;
+		case INT64_ARRAY:
+			msg.write_int64_array(p.get_int64_array(name));
+			break;
+		case UINT16_ARRAY:
+			msg.write_uint16_array(p.get_uint16_array(name));
+			break;
+		case UINT32_ARRAY:
+			msg.write_uint32_array(p.get_uint32_array(name));
+			break;
+		case UINT64_ARRAY:
+			msg.write_uint64_array(p.get_uint64_array(name));
+			break;
+		case FLOAT_ARRAY:
+			msg.write_float_array(p.get_float_array(name));
+			break;
+		case DOUBLE_ARRAY:
+			msg.write_double_array(p.get_double_array(name));
+			break;
+		case STRING_ARRAY:
+			msg.write_string_array(p.get_string_array(name));
+			break;
+		case LOCAL_MATRIX:
+			msg.write_local_matrix(*p.get_local_matrix(name));
+			break;
 		case ARRAY_ID:
 			msg.write_ArrayID(p.get_matrix_info(name)->ID);
 			break;
@@ -663,7 +861,7 @@ ArrayID GroupDriver::new_matrix(const ArrayInfo_ptr x)
 
 WorkerID * GroupDriver::get_row_assignments(ArrayID & matrixID)
 {
-	return matrices[matrixID]->worker_assignments;
+	return matrices[matrixID]->worker_assignments.data();
 }
 
 bool GroupDriver::check_libraryID(LibraryID & libID)
@@ -680,7 +878,6 @@ ArrayInfo_ptr GroupDriver::get_matrix_info(const ArrayID matrixID)
 {
 	return matrices[matrixID];
 }
-
 void GroupDriver::determine_row_assignments(ArrayID & matrixID)
 {
 	uint64_t worker_num_rows;
@@ -700,13 +897,14 @@ void GroupDriver::determine_row_assignments(ArrayID & matrixID)
 	MPI_Bcast(&matrices[matrixID]->ID, 1, MPI_UNSIGNED_SHORT, 0, group);
 	MPI_Barrier(group);
 
-	for (auto it = workers.begin(); it != workers.end(); it++) {
+	int rank = 1;
+	for (auto it = workers.begin(); it != workers.end(); it++, rank++) {
 		WorkerID id = it->first;
-		MPI_Recv(&worker_num_rows, 1, MPI_UNSIGNED_LONG, id, 0, group, &status);
+		MPI_Recv(&worker_num_rows, 1, MPI_UNSIGNED_LONG, rank, 0, group, &status);
 
 		row_indices = new uint64_t[worker_num_rows];
 
-		MPI_Recv(row_indices, (int) worker_num_rows, MPI_UNSIGNED_LONG, id, 0, group, &status);
+		MPI_Recv(row_indices, (int) worker_num_rows, MPI_UNSIGNED_LONG, rank, 0, group, &status);
 		for (uint64_t i = 0; i < worker_num_rows; i++) {
 			matrices[matrixID]->worker_assignments[row_indices[i]] = id;
 		}
@@ -779,13 +977,394 @@ vector<vector<vector<float> > > GroupDriver::prepare_data_layout_table(uint16_t
 
 // ----------------------------------------   File I/O   ----------------------------------------
 
-int GroupDriver::read_HDF5() {
+// Loads a matrix written by save_matrix, a 1D or 2D dataset of an HDF5 file, a text file or a flat binary file (see
+// matrix_file_format) into a new matrix; the workers read their own rows straight from the file (see
+// GroupWorker::load_matrix_file), the driver only registers the matrix. Returns 0 if the file could not be read.
+ArrayID GroupDriver::load_matrix_file(const string & file_name, const string & dataset_name, uint8_t format, uint64_t num_cols)
+{
+	alchemist_command command = _AM_LOAD_MATRIX_FILE;
 
-	log->info(string("GroupDriver::read_HDF5 not yet implemented"));
+	log->info("Sending command {} to workers", get_command_name(command));
 
+	MPI_Request req;
+	MPI_Status status;
+	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
+	MPI_Wait(&req, &status);
 
+	uint16_t file_name_length = (uint16_t) file_name.length();
+	uint16_t dataset_name_length = (uint16_t) dataset_name.length();
 
-	return 0;
+	MPI_Bcast(&file_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast((void *) file_name.c_str(), file_name_length+1, MPI_CHAR, 0, group);
+	MPI_Bcast(&dataset_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast((void *) dataset_name.c_str(), dataset_name_length+1, MPI_CHAR, 0, group);
+	MPI_Bcast(&format, 1, MPI_UNSIGNED_CHAR, 0, group);
+	MPI_Bcast(&num_cols, 1, MPI_UNSIGNED_LONG, 0, group);
+
+	return register_loaded_matrix(dataset_name.empty() ? file_name : dataset_name, file_name);
+}
+
+// Reloads a matrix from a snapshot taken by save_snapshot
+ArrayID GroupDriver::load_snapshot(const string & path)
+{
+	alchemist_command command = _AM_LOAD_SNAPSHOT;
+
+	log->info("Sending command {} to workers", get_command_name(command));
+
+	MPI_Request req;
+	MPI_Status status;
+	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
+	MPI_Wait(&req, &status);
+
+	uint16_t path_length = (uint16_t) path.length();
+
+	MPI_Bcast(&path_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast((void *) path.c_str(), path_length+1, MPI_CHAR, 0, group);
+
+	return register_loaded_matrix(path, path);
+}
+
+// Registers a matrix the workers are reading from a file, once the primary group worker has sent its dimensions (zeros
+// if the workers could not read it), and tells the workers its ID (0 on failure). The matrix is dropped again if any of
+// the workers then fails to read its rows.
+ArrayID GroupDriver::register_loaded_matrix(const string & name, const string & source)
+{
+	MPI_Status status;
+
+	uint64_t dims[2];
+	MPI_Recv(dims, 2, MPI_UNSIGNED_LONG, 1, 0, group, &status);
+
+	ArrayID matrixID = 0;
+
+	if (dims[0] > 0 && dims[1] > 0) {
+		matrixID = next_matrixID++;
+
+		uint8_t num_partitions = (uint8_t) workers.size();
+		matrices.insert(std::make_pair(matrixID, std::make_shared<ArrayInfo>(matrixID, name, dims[0], dims[1], 0, 0, num_partitions)));
+	}
+	else log->info("Unable to read matrix from {}", source);
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+
+	if (matrixID > 0) {
+		std::clock_t start = std::clock();
+
+		// Whether all of the workers managed to read their rows
+		int success;
+		MPI_Recv(&success, 1, MPI_INT, 1, 0, group, &status);
+
+		if (!success) {
+			log->info("Unable to read matrix {} from {}", matrixID, source);
+			matrices.erase(matrixID);
+
+			return 0;
+		}
+
+		determine_row_assignments(matrixID);
+
+		log->info("Loaded {}x{} matrix {} from {} in {}ms", dims[0], dims[1], matrixID, source,
+				1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+	}
+
+	return matrixID;
+}
+
+// Writes a matrix to a file that load_matrix_file can read back. The workers write their rows in parallel with
+// collective MPI-IO into a single file, so the path has to be on a file system all of them can reach.
+bool GroupDriver::save_matrix(ArrayID matrixID, const string & file_name)
+{
+	return write_matrix(_AM_SAVE_MATRIX, matrixID, file_name);
+}
+
+// Writes a snapshot of a matrix that load_snapshot can map straight back into memory. Each worker writes a file of its
+// own next to the path ("<path>.<rank>"), which is all a group with the same grid needs to reload the matrix.
+bool GroupDriver::save_snapshot(ArrayID matrixID, const string & path)
+{
+	return write_matrix(_AM_SAVE_SNAPSHOT, matrixID, path);
+}
+
+bool GroupDriver::write_matrix(alchemist_command command, ArrayID matrixID, const string & file_name)
+{
+	if (matrices.find(matrixID) == matrices.end()) {
+		log->info("Unable to save matrix {}: No such matrix", matrixID);
+		return false;
+	}
+
+	log->info("Sending command {} to workers", get_command_name(command));
+
+	MPI_Request req;
+	MPI_Status status;
+	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
+	MPI_Wait(&req, &status);
+
+	uint16_t file_name_length = (uint16_t) file_name.length();
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&file_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast((void *) file_name.c_str(), file_name_length+1, MPI_CHAR, 0, group);
+
+	std::clock_t start = std::clock();
+
+	// Whether all of the workers managed to write their rows
+	int success;
+	MPI_Recv(&success, 1, MPI_INT, 1, 0, group, &status);
+
+	if (success) log->info("Saved matrix {} to {} in {}ms", matrixID, file_name,
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+	else log->info("Unable to save matrix {} to {}", matrixID, file_name);
+
+	return success != 0;
+}
+
+// ------------------------------------   Built-in Operations   ----------------------------------
+
+// Built-in operations run on the workers straight from the command, without going through a library; each returns
+// the ID of the new matrix holding the result, or 0 with ec set if the operands are not valid
+
+ArrayID GroupDriver::get_transpose(ArrayID matrixID, alchemist_error_code & ec)
+{
+	if (!has_matrix(matrixID)) {
+		ec = ERR_INVALID_MATRIX;
+		return 0;
+	}
+
+	ArrayInfo_ptr A = matrices[matrixID];
+
+	send_command(_AM_MATRIX_TRANSPOSE);
+
+	ArrayID IDs[2] = {matrixID, next_matrixID};
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+
+	return register_result(A->name + "^T", A->num_cols, A->num_rows);
+}
+
+ArrayID GroupDriver::matrix_multiply(ArrayID matrixID_A, ArrayID matrixID_B, alchemist_error_code & ec)
+{
+	if (!has_matrix(matrixID_A) || !has_matrix(matrixID_B)) {
+		ec = ERR_INVALID_MATRIX;
+		return 0;
+	}
+
+	ArrayInfo_ptr A = matrices[matrixID_A];
+	ArrayInfo_ptr B = matrices[matrixID_B];
+
+	if (A->num_cols != B->num_rows) {
+		ec = ERR_DIMENSION_MISMATCH;
+		return 0;
+	}
+
+	send_command(_AM_MATRIX_MULTIPLY);
+
+	ArrayID IDs[3] = {matrixID_A, matrixID_B, next_matrixID};
+	MPI_Bcast(IDs, 3, MPI_UNSIGNED_SHORT, 0, group);
+
+	return register_result(A->name + "*" + B->name, A->num_rows, B->num_cols);
+}
+
+ArrayID GroupDriver::get_matrix_rows(ArrayID matrixID, const vector<uint64_t> & rows, alchemist_error_code & ec)
+{
+	if (!has_matrix(matrixID)) {
+		ec = ERR_INVALID_MATRIX;
+		return 0;
+	}
+
+	ArrayInfo_ptr A = matrices[matrixID];
+
+	if (rows.empty() || std::any_of(rows.begin(), rows.end(), [&A](uint64_t row) { return row >= A->num_rows; })) {
+		ec = ERR_DIMENSION_MISMATCH;
+		return 0;
+	}
+
+	send_command(_AM_MATRIX_ROWS);
+
+	ArrayID IDs[2] = {matrixID, next_matrixID};
+	uint64_t num_rows = (uint64_t) rows.size();
+
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&num_rows, 1, MPI_UNSIGNED_LONG, 0, group);
+	MPI_Bcast((void *) rows.data(), (int) num_rows, MPI_UNSIGNED_LONG, 0, group);
+
+	return register_result(A->name + "[rows]", num_rows, A->num_cols);
+}
+
+// Creates a view of a range of rows and a range of columns of a matrix, each given by its start, end (exclusive) and
+// stride, as in ArrayBlock; the view may also be transposed. Views are materialized by the workers when first used (see
+// GroupWorker::create_view).
+ArrayID GroupDriver::create_view(ArrayID matrixID, uint64_t dims[6], bool transposed, alchemist_error_code & ec)
+{
+	if (!has_matrix(matrixID)) {
+		ec = ERR_INVALID_MATRIX;
+		return 0;
+	}
+
+	ArrayInfo_ptr A = matrices[matrixID];
+
+	if (dims[2] == 0 || dims[5] == 0 || dims[0] >= dims[1] || dims[1] > A->num_rows || dims[3] >= dims[4] || dims[4] > A->num_cols) {
+		ec = ERR_DIMENSION_MISMATCH;
+		return 0;
+	}
+
+	uint64_t num_rows = (dims[1] - dims[0] + dims[2] - 1)/dims[2];
+	uint64_t num_cols = (dims[4] - dims[3] + dims[5] - 1)/dims[5];
+	uint8_t flag = transposed ? 1 : 0;
+
+	send_command(_AM_MATRIX_VIEW);
+
+	ArrayID IDs[2] = {matrixID, next_matrixID};
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(dims, 6, MPI_UNSIGNED_LONG, 0, group);
+	MPI_Bcast(&flag, 1, MPI_UNSIGNED_CHAR, 0, group);
+
+	if (transposed) return register_result(A->name + "[view]^T", num_cols, num_rows);
+	return register_result(A->name + "[view]", num_rows, num_cols);
+}
+
+// Creates a matrix with random entries from the given distribution, with params[0] and params[1] being its parameters a
+// and b as described in utility/random_matrix.hpp. The same seed always gives the same matrix.
+ArrayID GroupDriver::generate_matrix(uint64_t num_rows, uint64_t num_cols, random_distribution dist, uint64_t seed,
+		double params[2], alchemist_error_code & ec)
+{
+	RandomMatrixGenerator generator(dist, seed, params[0], params[1], num_rows, num_cols);
+
+	if (num_rows == 0 || num_cols == 0 || !generator.valid()) {
+		ec = ERR_INVALID_ARGUMENT;
+		return 0;
+	}
+
+	send_command(_AM_GENERATE_MATRIX);
+
+	uint64_t args[3] = {num_rows, num_cols, seed};
+	uint8_t d = (uint8_t) dist;
+
+	MPI_Bcast(&next_matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(args, 3, MPI_UINT64_T, 0, group);
+	MPI_Bcast(params, 2, MPI_DOUBLE, 0, group);
+	MPI_Bcast(&d, 1, MPI_UINT8_T, 0, group);
+
+	return register_result(string(get_random_distribution_name(dist)) + "(" + std::to_string(seed) + ")", num_rows, num_cols);
+}
+
+// Computes summary statistics of every column of a matrix, returned as array parameters with one entry per column:
+// count and nan_count (numbers of values that are and are not NaN), mean, variance (sample variance), min, max, norm_l1
+// and norm_l2; NaNs are left out of everything but nan_count
+bool GroupDriver::get_matrix_stats(ArrayID matrixID, Parameters & stats, alchemist_error_code & ec)
+{
+	if (!has_matrix(matrixID)) {
+		ec = ERR_INVALID_MATRIX;
+		return false;
+	}
+
+	send_command(_AM_MATRIX_STATS);
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+
+	uint64_t num_cols = matrices[matrixID]->num_cols;
+	vector<ColumnStats> column_stats(num_cols);
+
+	MPI_Status status;
+	MPI_Recv(column_stats.data(), (int) (num_cols*sizeof(ColumnStats)/sizeof(double)), MPI_DOUBLE, 1, 0, group, &status);
+
+	vector<uint64_t> count(num_cols), nan_count(num_cols);
+	vector<double> mean(num_cols), variance(num_cols), min(num_cols), max(num_cols), norm_l1(num_cols), norm_l2(num_cols);
+
+	for (uint64_t j = 0; j < num_cols; j++) {
+		const ColumnStats & s = column_stats[j];
+		count[j] = (uint64_t) s.count;
+		nan_count[j] = (uint64_t) s.nan_count;
+		mean[j] = (s.count > 0) ? s.mean : NAN;
+		variance[j] = s.variance();
+		min[j] = (s.count > 0) ? s.min : NAN;
+		max[j] = (s.count > 0) ? s.max : NAN;
+		norm_l1[j] = s.sum_abs;
+		norm_l2[j] = std::sqrt(s.sum_squares);
+	}
+
+	stats.add_uint64_array("count", count);
+	stats.add_uint64_array("nan_count", nan_count);
+	stats.add_double_array("mean", mean);
+	stats.add_double_array("variance", variance);
+	stats.add_double_array("min", min);
+	stats.add_double_array("max", max);
+	stats.add_double_array("norm_l1", norm_l1);
+	stats.add_double_array("norm_l2", norm_l2);
+
+	log->info("Computed statistics of matrix {}", matrixID);
+
+	return true;
+}
+
+// Evaluates an elementwise expression (see utility/expression.hpp) over matrices of the same shape, into a new matrix if
+// targetID is 0 and into the matrix targetID otherwise, which may be one of the operands
+ArrayID GroupDriver::evaluate_expression(const string & expression, const vector<ArrayID> & operandIDs, ArrayID targetID, alchemist_error_code & ec)
+{
+	if (operandIDs.empty() || (targetID > 0 && !has_matrix(targetID)) ||
+			std::any_of(operandIDs.begin(), operandIDs.end(), [this](ArrayID ID) { return !has_matrix(ID); })) {
+		ec = ERR_INVALID_MATRIX;
+		return 0;
+	}
+
+	ArrayInfo_ptr A = matrices[operandIDs[0]];
+
+	for (ArrayID ID : operandIDs)
+		if (matrices[ID]->num_rows != A->num_rows || matrices[ID]->num_cols != A->num_cols) {
+			ec = ERR_DIMENSION_MISMATCH;
+			return 0;
+		}
+	if (targetID > 0 && (matrices[targetID]->num_rows != A->num_rows || matrices[targetID]->num_cols != A->num_cols)) {
+		ec = ERR_DIMENSION_MISMATCH;
+		return 0;
+	}
+
+	// Compiled here as well, so that errors are reported before the workers see the expression
+	Expression compiled;
+	string error;
+	if (!compiled.compile(expression, operandIDs.size(), error)) {
+		log->info("Invalid expression '{}': {}", expression, error);
+		ec = ERR_INVALID_EXPRESSION;
+		return 0;
+	}
+
+	send_command(_AM_MATRIX_EXPRESSION);
+
+	uint16_t header[3] = {targetID > 0 ? targetID : next_matrixID, (uint16_t) (targetID > 0 ? 1 : 0), (uint16_t) operandIDs.size()};
+	uint32_t expression_length = (uint32_t) expression.length();
+
+	MPI_Bcast(header, 3, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast((void *) operandIDs.data(), (int) operandIDs.size(), MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&expression_length, 1, MPI_UNSIGNED, 0, group);
+	MPI_Bcast((void *) expression.c_str(), (int) expression_length+1, MPI_CHAR, 0, group);
+
+	if (targetID > 0) {
+		log->info("Evaluated '{}' into matrix {}", expression, targetID);
+		return targetID;
+	}
+
+	return register_result(expression, A->num_rows, A->num_cols);
+}
+
+void GroupDriver::send_command(alchemist_command command)
+{
+	log->info("Sending command {} to workers", get_command_name(command));
+
+	MPI_Request req;
+	MPI_Status status;
+	MPI_Ibcast(&command, 1, MPI_UNSIGNED_CHAR, 0, group, &req);
+	MPI_Wait(&req, &status);
+}
+
+// Registers the matrix the workers have just computed under the next ID and collects its layout
+ArrayID GroupDriver::register_result(const string & name, uint64_t num_rows, uint64_t num_cols)
+{
+	ArrayID matrixID = next_matrixID++;
+
+	uint8_t num_partitions = (uint8_t) workers.size();
+	matrices.insert(std::make_pair(matrixID, std::make_shared<ArrayInfo>(matrixID, name, num_rows, num_cols, 0, 0, num_partitions)));
+
+	determine_row_assignments(matrixID);
+
+	log->info("Created {}x{} matrix {} ({})", num_rows, num_cols, matrixID, name);
+
+	return matrixID;
 }
 
 // ---------------------------------------   Information   ---------------------------------------
@@ -27,18 +27,27 @@ public:
 	DriverSession_ptr session;
 
 	map<WorkerID, WorkerInfo_ptr> workers;
+	vector<WorkerID> formed_workers;			// Workers the group's communicator was last formed with (sorted)
 
 	void free_group();
 	void ready_group();
-	void set_group_comm(MPI_Comm & world, MPI_Group & temp_group);
+	void set_group_comm(MPI_Comm & world, MPI_Group & temp_group, bool cached);
+	void reuse_group_comm(const MPI_Comm & cached_group);
+	const MPI_Comm & get_group_comm() const;
+	void redistribute_matrices(MPI_Comm & handover, const vector<WorkerID> & handover_workers);
 
-	const map<WorkerID, WorkerInfo_ptr> & allocate_workers(const uint16_t & num_requested_workers);
+	const map<WorkerID, WorkerInfo_ptr> & allocate_workers(const uint16_t & num_requested_workers, const allocation_policy policy = ALLOCATE_IN_ORDER);
 	vector<WorkerID> deallocate_workers(const vector<WorkerID> & yielded_workers);
+	void release_workers();
+	bool request_workers(const uint16_t num_requested_workers, const allocation_policy policy, const uint8_t priority, const uint32_t timeout,
+			std::function<void(const alchemist_error_code)> handler);
 
 	string list_workers();
 	uint16_t get_num_workers();
 
 	ArrayInfo_ptr get_matrix_info(const ArrayID matrixID);
+	bool has_matrices() const { return !matrices.empty(); }
+	bool has_matrix(const ArrayID matrixID) const { return matrices.find(matrixID) != matrices.end(); }
 
 	string list_sessions();
 	LibraryID load_library(string library_name, string library_path);
@@ -50,7 +59,21 @@ public:
 
 	// ----------------------------------------   File I/O   ----------------------------------------
 
-	int read_HDF5();
+	ArrayID load_matrix_file(const string & file_name, const string & dataset_name, uint8_t format = AUTO_FORMAT, uint64_t num_cols = 0);
+	bool save_matrix(ArrayID matrixID, const string & file_name);
+	ArrayID load_snapshot(const string & path);
+	bool save_snapshot(ArrayID matrixID, const string & path);
+
+	// ------------------------------------   Built-in Operations   ----------------------------------
+
+	ArrayID get_transpose(ArrayID matrixID, alchemist_error_code & ec);
+	ArrayID matrix_multiply(ArrayID matrixID_A, ArrayID matrixID_B, alchemist_error_code & ec);
+	ArrayID get_matrix_rows(ArrayID matrixID, const vector<uint64_t> & rows, alchemist_error_code & ec);
+	ArrayID create_view(ArrayID matrixID, uint64_t dims[6], bool transposed, alchemist_error_code & ec);
+	ArrayID generate_matrix(uint64_t num_rows, uint64_t num_cols, random_distribution dist, uint64_t seed, double params[2],
+			alchemist_error_code & ec);
+	bool get_matrix_stats(ArrayID matrixID, Parameters & stats, alchemist_error_code & ec);
+	ArrayID evaluate_expression(const string & expression, const vector<ArrayID> & operandIDs, ArrayID targetID, alchemist_error_code & ec);
 
 //	int run_task(LibraryID libID, string task, ArrayID matrixID, uint32_t rank, uint8_t method);
 	void run_task(const char * & in_data, uint32_t & in_data_length, char * & out_data, uint32_t & out_data_length, client_language cl);
@@ -82,6 +105,7 @@ public:
 	void idle_workers();
 private:
 	MPI_Comm group;
+	bool group_comm_cached;
 
 	GroupID ID;
 	client_language cl;
@@ -95,6 +119,11 @@ private:
 	LibraryID next_libraryID;
 
 	Log_ptr log;
+
+	ArrayID register_loaded_matrix(const string & name, const string & source);
+	ArrayID register_result(const string & name, uint64_t num_rows, uint64_t num_cols);
+	void send_command(alchemist_command command);
+	bool write_matrix(alchemist_command command, ArrayID matrixID, const string & file_name);
 };
 
 typedef std::shared_ptr<GroupDriver> GroupDriver_ptr;
@@ -1,4 +1,5 @@
 #include "GroupWorker.hpp"
+#include <omp.h>
 
 namespace alchemist {
 
@@ -16,7 +17,7 @@ GroupWorker::GroupWorker(GroupID _groupID, Worker & _worker, io_context & _io_co
 
 GroupWorker::GroupWorker(GroupID _groupID, Worker & _worker, io_context & _io_context, const tcp::endpoint & endpoint, bool _primary_group_worker, Log_ptr & _log) :
 			Server(_io_context, endpoint, _log), grid(nullptr), current_grid(-1), groupID(_groupID), group(MPI_COMM_NULL), group_peers(MPI_COMM_NULL), worker(_worker),
-			next_sessionID(0), current_matrixID(0), connection_open(false), primary_group_worker(_primary_group_worker)
+			next_sessionID(0), current_matrixID(0), connection_open(false), primary_group_worker(_primary_group_worker), group_comms_cached(false)
 {
 	workerID = worker.get_ID();
 
@@ -25,15 +26,22 @@ GroupWorker::GroupWorker(GroupID _groupID, Worker & _worker, io_context & _io_co
 
 GroupWorker::~GroupWorker() { }
 
+void GroupWorker::set_group(GroupID _groupID, bool _primary_group_worker)
+{
+	groupID = _groupID;
+	primary_group_worker = _primary_group_worker;
+}
+
+// The group ID is used as tag so that groups can be formed concurrently
 void GroupWorker::set_group_comm(MPI_Comm & world, MPI_Group & temp_group)
 {
-	MPI_Comm_create_group(world, temp_group, 0, &group);
+	MPI_Comm_create_group(world, temp_group, groupID, &group);
 	MPI_Barrier(group);
 }
 
 void GroupWorker::set_group_peers_comm(MPI_Comm & world, MPI_Group & temp_group)
 {
-	MPI_Comm_create_group(world, temp_group, 0, &group_peers);
+	MPI_Comm_create_group(world, temp_group, groupID, &group_peers);
 
 //
 //	MPI_Barrier(group_peers);
@@ -42,12 +50,156 @@ void GroupWorker::set_group_peers_comm(MPI_Comm & world, MPI_Group & temp_group)
 //		grid = nullptr;
 //		grid.reset(new El::Grid(El::mpi::Comm(group_peers)));
 //	}
+	previous_grid = grid;
 	grid = std::make_shared<El::Grid>(El::mpi::Comm(group_peers));
 	MPI_Barrier(group_peers);
 
 //	current_grid++;
 //	grids.push_back(std::make_shared<El::Grid>(El::mpi::Comm(group_peers)));
 //	layout_matrices();
+
+	group_comms_cached = false;
+}
+
+void GroupWorker::cache_group_comms(const vector<WorkerID> & peers)
+{
+	cached_group_comms[peers] = GroupComms{group, group_peers, grid};
+	group_comms_cached = true;
+}
+
+void GroupWorker::reuse_group_comms(const vector<WorkerID> & peers)
+{
+	const GroupComms & comms = cached_group_comms[peers];
+
+	group = comms.group;
+	group_peers = comms.group_peers;
+	previous_grid = grid;
+	grid = comms.grid;
+	group_comms_cached = true;
+}
+
+// Moves the rows of the group's matrices from the workers the group was formed with before onto the new grid, over a
+// communicator with the driver (rank 0) and both sets of workers. All matrices end up as [VR,STAR] matrices, in which
+// row i is held by the worker whose column shift is i modulo the number of workers, so every worker can tell from the
+// gathered shifts where each of its rows goes and where each of its new rows comes from. Workers that have left the
+// group hand over their rows and drop their matrices, workers that have joined it start with none.
+void GroupWorker::redistribute_matrices(MPI_Comm & handover, bool previous_member, bool member)
+{
+	std::clock_t start = std::clock();
+
+	int handover_size;
+	MPI_Comm_size(handover, &handover_size);
+
+	uint32_t num_matrices;
+	MPI_Bcast(&num_matrices, 1, MPI_UNSIGNED, 0, handover);
+
+	vector<uint64_t> specs(3*num_matrices);
+	MPI_Bcast(specs.data(), (int) specs.size(), MPI_UNSIGNED_LONG, 0, handover);
+
+	map<ArrayID, DistMatrix_ptr> redistributed_matrices;
+
+	for (uint32_t k = 0; k < num_matrices; k++) {
+		ArrayID ID = (ArrayID) specs[3*k];
+		El::Int num_rows = (El::Int) specs[3*k+1];
+		El::Int num_cols = (El::Int) specs[3*k+2];
+
+		DistMatrix_ptr A = nullptr, B = nullptr;
+
+		if (previous_member) {
+			A = get_matrix(ID);
+
+			// Matrices created by libraries may have other layouts; these are converted on the previous grid first
+			if (A->ColDist() != El::VR || A->RowDist() != El::STAR) {
+				DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(A->Grid());
+				El::Copy(*A, *C);
+				A = C;
+			}
+		}
+
+		if (member) B = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(num_rows, num_cols, *grid);
+
+		int shifts[3] = {-1, 0, -1};
+		if (A != nullptr) {
+			shifts[0] = (int) A->ColShift();
+			shifts[1] = (int) A->ColStride();
+		}
+		if (B != nullptr) shifts[2] = (int) B->ColShift();
+
+		vector<int> all_shifts(3*handover_size);
+		MPI_Allgather(shifts, 3, MPI_INT, all_shifts.data(), 3, MPI_INT, handover);
+
+		// Ranks of the previous and of the new holder of the rows with a given shift
+		vector<int> previous_owners, owners;
+		for (int r = 1; r < handover_size; r++) {
+			if (all_shifts[3*r] >= 0) previous_owners.resize(all_shifts[3*r+1]);
+			if (all_shifts[3*r+2] >= 0) owners.resize(owners.size()+1);
+		}
+		for (int r = 1; r < handover_size; r++) {
+			if (all_shifts[3*r] >= 0) previous_owners[all_shifts[3*r]] = r;
+			if (all_shifts[3*r+2] >= 0) owners[all_shifts[3*r+2]] = r;
+		}
+
+		El::Int num_previous_owners = (El::Int) previous_owners.size();
+		El::Int num_owners = (El::Int) owners.size();
+
+		// Counts and displacements are in rows, so that they stay within an int for large matrices
+		vector<int> send_counts(handover_size, 0), send_displs(handover_size, 0);
+		vector<int> recv_counts(handover_size, 0), recv_displs(handover_size, 0);
+
+		if (A != nullptr)
+			for (El::Int i = 0; i < A->LocalHeight(); i++) send_counts[owners[A->GlobalRow(i) % num_owners]]++;
+		if (B != nullptr)
+			for (El::Int i = 0; i < B->LocalHeight(); i++) recv_counts[previous_owners[B->GlobalRow(i) % num_previous_owners]]++;
+
+		for (int r = 1; r < handover_size; r++) {
+			send_displs[r] = send_displs[r-1] + send_counts[r-1];
+			recv_displs[r] = recv_displs[r-1] + recv_counts[r-1];
+		}
+
+		vector<double> send_buffer((size_t) (send_displs.back() + send_counts.back())*num_cols + 1);
+		vector<double> recv_buffer((size_t) (recv_displs.back() + recv_counts.back())*num_cols + 1);
+
+		// Rows are packed and unpacked in increasing order on both sides, so each pair of workers agrees on the order
+		// of the rows that go from one to the other
+		if (A != nullptr) {
+			vector<int> position(send_displs);
+			const double * data = A->LockedMatrix().LockedBuffer();
+			El::Int ldim = A->LockedMatrix().LDim();
+
+			for (El::Int i = 0; i < A->LocalHeight(); i++) {
+				double * row = send_buffer.data() + (size_t) position[owners[A->GlobalRow(i) % num_owners]]++*num_cols;
+				for (El::Int j = 0; j < num_cols; j++) row[j] = data[i + j*ldim];
+			}
+		}
+
+		MPI_Datatype row_type;
+		MPI_Type_contiguous((int) num_cols, MPI_DOUBLE, &row_type);
+		MPI_Type_commit(&row_type);
+
+		MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displs.data(), row_type,
+				recv_buffer.data(), recv_counts.data(), recv_displs.data(), row_type, handover);
+
+		MPI_Type_free(&row_type);
+
+		if (B != nullptr) {
+			vector<int> position(recv_displs);
+			double * data = B->Matrix().Buffer();
+			El::Int ldim = B->Matrix().LDim();
+
+			for (El::Int i = 0; i < B->LocalHeight(); i++) {
+				const double * row = recv_buffer.data() + (size_t) position[previous_owners[B->GlobalRow(i) % num_previous_owners]]++*num_cols;
+				for (El::Int j = 0; j < num_cols; j++) data[i + j*ldim] = row[j];
+			}
+
+			redistributed_matrices.insert(std::make_pair(ID, B));
+		}
+	}
+
+	// Nothing refers to the previous grid any more
+	matrices = redistributed_matrices;
+	previous_grid = nullptr;
+
+	log->info("Redistributing {} matrices took {}ms", num_matrices, 1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
 }
 
 WorkerID GroupWorker::get_workerID()
@@ -57,7 +209,7 @@ WorkerID GroupWorker::get_workerID()
 
 GroupID GroupWorker::get_groupID()
 {
-	return workerID;
+	return groupID;
 }
 
 int GroupWorker::start()
@@ -81,9 +233,738 @@ int GroupWorker::close_client()
 
 // ----------------------------------------   File I/O   ----------------------------------------
 
-int GroupWorker::read_HDF5() {
+// Loads a matrix saved by SAVE_MATRIX, a dataset of an HDF5 file, a delimited text file or a flat binary file. The file
+// is opened by the workers alone and each worker reads just its own part of it; the driver only learns the dimensions
+// and assigns the ID.
+int GroupWorker::load_matrix_file()
+{
+	uint16_t file_name_length, dataset_name_length;
+	uint8_t format;
+	uint64_t num_cols;
+
+	MPI_Bcast(&file_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	char file_name_c[file_name_length+1];
+	MPI_Bcast(file_name_c, file_name_length+1, MPI_CHAR, 0, group);
+
+	MPI_Bcast(&dataset_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	char dataset_name_c[dataset_name_length+1];
+	MPI_Bcast(dataset_name_c, dataset_name_length+1, MPI_CHAR, 0, group);
+
+	MPI_Bcast(&format, 1, MPI_UNSIGNED_CHAR, 0, group);
+	MPI_Bcast(&num_cols, 1, MPI_UNSIGNED_LONG, 0, group);
+
+	string file_name = string(file_name_c);
+	string dataset_name = string(dataset_name_c);
+
+	if (format == AUTO_FORMAT || format == NATIVE_FORMAT) {
+		MPI_File file;
+		MatrixFileHeader header;
+
+		// Every worker reads the header, so all of them agree on whether this is a matrix file
+		int rc = MPI_File_open(group_peers, file_name.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
+		if (rc == MPI_SUCCESS) {
+			MPI_Status status;
+			MPI_File_read_at_all(file, 0, &header, sizeof(MatrixFileHeader), MPI_BYTE, &status);
+			if (!header.valid()) MPI_File_close(&file);
+		}
 
-	log->info("GroupWorker::read_HDF5 not yet implemented");
+		if (rc == MPI_SUCCESS && header.valid()) return read_matrix_file(file, header, file_name);
+
+		if (format == AUTO_FORMAT) format = get_matrix_file_format(file_name);
+	}
+
+	switch (format) {
+		case TEXT_FORMAT:
+			return read_text_file(file_name);
+		case RAW_FORMAT:
+			return read_raw_file(file_name, num_cols);
+		case HDF5_FORMAT:
+			return read_HDF5(file_name, dataset_name);
+		default:
+			log->info("{} {} is not a matrix file", client_preamble(), file_name);
+			uint64_t dims[2] = {0, 0};
+			register_file_matrix(dims);
+			return 0;
+	}
+}
+
+// Reads the rest of a file written by SAVE_MATRIX; closes the file
+int GroupWorker::read_matrix_file(MPI_File & file, const MatrixFileHeader & header, const string & file_name)
+{
+	uint64_t dims[2] = {header.num_rows, header.num_cols};
+
+	// The file has to be long enough for the rows the header promises, e.g. it is not a truncated copy
+	MPI_Offset length = 0;
+	MPI_File_get_size(file, &length);
+	uint64_t data_length = (uint64_t) std::max(length - (MPI_Offset) sizeof(MatrixFileHeader), (MPI_Offset) 0);
+	if (dims[1] > 0 && (dims[0] > data_length/8/dims[1])) {
+		log->info("{} {} is too short for a {}x{} matrix", client_preamble(), file_name, dims[0], dims[1]);
+		dims[0] = dims[1] = 0;
+	}
+
+	ArrayID matrixID = register_file_matrix(dims);
+
+	if (matrixID > 0) {
+		DistMatrix_ptr M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>((El::Int) dims[0], (El::Int) dims[1], *grid);
+
+		int success = transfer_matrix_rows(file, M, sizeof(MatrixFileHeader), false);
+		if (success) log->info("{} Read {} rows of matrix {} from {}", client_preamble(), M->LocalHeight(), matrixID, file_name);
+		else log->info("{} Error while reading matrix {} from {}", client_preamble(), matrixID, file_name);
+
+		MPI_File_close(&file);
+
+		finish_file_matrix(matrixID, M, success);
+	}
+	else MPI_File_close(&file);
+
+	return 0;
+}
+
+// Reads a flat file of little-endian doubles, a row at a time, with the given number of columns. Rows are contiguous,
+// so this is the same collective read as for files written by SAVE_MATRIX, just without the header.
+int GroupWorker::read_raw_file(const string & file_name, const uint64_t num_cols)
+{
+	MPI_File file;
+	MPI_Offset length = 0;
+	uint64_t dims[2] = {0, num_cols};
+
+	int readable = (MPI_File_open(group_peers, file_name.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file) == MPI_SUCCESS);
+	if (readable) {
+		MPI_File_get_size(file, &length);
+		if (num_cols > 0 && length > 0 && (uint64_t) length % (8*num_cols) == 0) dims[0] = (uint64_t) length/(8*num_cols);
+		else {
+			log->info("{} Size of {} ({} bytes) is not a multiple of rows of {} doubles", client_preamble(), file_name, length, num_cols);
+			MPI_File_close(&file);
+			readable = 0;
+		}
+	}
+	else log->info("{} Unable to open {}", client_preamble(), file_name);
+
+	if (!readable) dims[0] = dims[1] = 0;
+
+	ArrayID matrixID = register_file_matrix(dims);
+
+	if (matrixID > 0) {
+		DistMatrix_ptr M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>((El::Int) dims[0], (El::Int) dims[1], *grid);
+
+		int success = transfer_matrix_rows(file, M, 0, false);
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		El::Matrix<double> & local = M->Matrix();
+		for (El::Int j = 0; j < local.Width(); j++) reverse_bytes_64((char *) local.Buffer(0, j), (size_t) local.Height());
+#endif
+
+		if (success) log->info("{} Read {} rows of matrix {} from {}", client_preamble(), M->LocalHeight(), matrixID, file_name);
+		else log->info("{} Error while reading matrix {} from {}", client_preamble(), matrixID, file_name);
+
+		MPI_File_close(&file);
+
+		finish_file_matrix(matrixID, M, success);
+	}
+	else if (readable) MPI_File_close(&file);
+
+	return 0;
+}
+
+// Reads a delimited text file, one row per line (blank lines are skipped, as is a first line that is not numeric).
+// The file is split into equal byte ranges, each worker taking the lines that start in its range, and each worker
+// parses its lines with all of its threads. The parsed rows are then sent on to the workers that own them.
+int GroupWorker::read_text_file(const string & file_name)
+{
+	std::clock_t start = std::clock();
+
+	int rank, num_peers;
+	MPI_Comm_rank(group_peers, &rank);
+	MPI_Comm_size(group_peers, &num_peers);
+
+	char * text = nullptr;
+	uint64_t length = 0;
+
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		struct stat sb;
+		if (fstat(fd, &sb) == 0 && sb.st_size > 0) {
+			length = (uint64_t) sb.st_size;
+			void * addr = mmap(nullptr, (size_t) length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr != MAP_FAILED) {
+				text = (char *) addr;
+				madvise(addr, (size_t) length, MADV_SEQUENTIAL);
+			}
+		}
+		::close(fd);
+	}
+
+	int readable = (text != nullptr);
+	MPI_Allreduce(MPI_IN_PLACE, &readable, 1, MPI_INT, MPI_MIN, group_peers);
+
+	vector<const char *> line_starts, line_ends;
+	uint64_t num_cols = 0;
+
+	if (readable) {
+		// A line belongs to the worker whose range holds its first character
+		auto next_line = [text, length](uint64_t pos) {
+			if (pos == 0 || pos >= length || text[pos-1] == '\n') return std::min(pos, length);
+			const char * newline = (const char *) memchr(text + pos, '\n', (size_t) (length - pos));
+			return newline == nullptr ? length : (uint64_t) (newline - text) + 1;
+		};
+
+		const char * p = text + next_line(length*rank/num_peers);
+		const char * end = text + next_line(length*(rank+1)/num_peers);
+
+		while (p < end) {
+			const char * newline = (const char *) memchr(p, '\n', (size_t) (end - p));
+			const char * line_end = (newline == nullptr) ? end : newline;
+
+			if (!is_blank_line(p, line_end)) {
+				line_starts.push_back(p);
+				line_ends.push_back(line_end);
+			}
+			p = line_end + 1;
+		}
+
+		// Skip a header
+		if (rank == 0 && !line_starts.empty() && parse_row(line_starts[0], line_ends[0], nullptr, 0) < 0) {
+			line_starts.erase(line_starts.begin());
+			line_ends.erase(line_ends.begin());
+		}
+
+		if (!line_starts.empty()) num_cols = (uint64_t) std::max(parse_row(line_starts[0], line_ends[0], nullptr, 0), (int64_t) 0);
+		MPI_Allreduce(MPI_IN_PLACE, &num_cols, 1, MPI_UNSIGNED_LONG, MPI_MAX, group_peers);
+	}
+
+	uint64_t num_local_rows = (uint64_t) line_starts.size();
+	vector<double> rows(num_local_rows*num_cols);
+	int64_t first_bad_line = -1;
+
+	#pragma omp parallel for schedule(static)
+	for (int64_t i = 0; i < (int64_t) num_local_rows; i++)
+		if (parse_row(line_starts[i], line_ends[i], rows.data() + i*num_cols, num_cols) != (int64_t) num_cols) {
+			#pragma omp critical
+			if (first_bad_line < 0 || i < first_bad_line) first_bad_line = i;
+		}
+
+	if (first_bad_line >= 0) {
+		log->info("{} Line at byte {} of {} does not hold {} numbers", client_preamble(),
+				(uint64_t) (line_starts[first_bad_line] - text), file_name, num_cols);
+		readable = 0;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &readable, 1, MPI_INT, MPI_MIN, group_peers);
+
+	uint64_t first_row = 0, num_rows = 0;
+	MPI_Exscan(&num_local_rows, &first_row, 1, MPI_UNSIGNED_LONG, MPI_SUM, group_peers);
+	if (rank == 0) first_row = 0;
+	MPI_Allreduce(&num_local_rows, &num_rows, 1, MPI_UNSIGNED_LONG, MPI_SUM, group_peers);
+
+	if (text != nullptr) munmap(text, (size_t) length);
+
+	uint64_t dims[2] = {num_rows, num_cols};
+	if (!readable || num_cols == 0) {
+		log->info("{} Unable to read {}", client_preamble(), file_name);
+		dims[0] = dims[1] = 0;
+	}
+
+	ArrayID matrixID = register_file_matrix(dims);
+
+	if (matrixID > 0) {
+		DistMatrix_ptr M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>((El::Int) dims[0], (El::Int) dims[1], *grid);
+
+		place_rows(M, rows, first_row, num_local_rows);
+
+		log->info("{} Parsed {} lines of {} for matrix {} in {}ms", client_preamble(), num_local_rows, file_name, matrixID,
+				1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+		finish_file_matrix(matrixID, M, 1);
+	}
+
+	return 0;
+}
+
+// Moves a block of consecutive rows of a [VR,STAR] matrix, starting at first_row and stored row by row, from this
+// worker to the workers that own them. Every worker passes its own block.
+void GroupWorker::place_rows(DistMatrix_ptr M, const vector<double> & rows, const uint64_t first_row, const uint64_t num_rows)
+{
+	int num_peers;
+	MPI_Comm_size(group_peers, &num_peers);
+
+	uint64_t num_cols = (uint64_t) M->Width();
+	uint64_t stride = (uint64_t) M->ColStride();
+
+	// Row shift of each worker, and the block of rows each worker holds
+	int shift = (int) M->ColShift();
+	vector<int> shifts(num_peers), peer_of_shift(num_peers);
+	MPI_Allgather(&shift, 1, MPI_INT, shifts.data(), 1, MPI_INT, group_peers);
+	for (int p = 0; p < num_peers; p++) peer_of_shift[shifts[p]] = p;
+
+	uint64_t block[2] = {first_row, num_rows};
+	vector<uint64_t> blocks(2*num_peers);
+	MPI_Allgather(block, 2, MPI_UNSIGNED_LONG, blocks.data(), 2, MPI_UNSIGNED_LONG, group_peers);
+
+	// Rows are sent grouped by the worker that owns them, keeping their order; counts and displacements are in rows, so
+	// that they stay within an int for large matrices
+	vector<int> send_counts(num_peers, 0), send_displs(num_peers, 0), recv_counts(num_peers, 0), recv_displs(num_peers, 0);
+	for (uint64_t i = 0; i < num_rows; i++) send_counts[peer_of_shift[(first_row + i) % stride]]++;
+	for (int p = 1; p < num_peers; p++) send_displs[p] = send_displs[p-1] + send_counts[p-1];
+
+	vector<double> send_buffer(rows.size());
+	vector<int> positions(send_displs);
+	for (uint64_t i = 0; i < num_rows; i++) {
+		uint64_t position = (uint64_t) positions[peer_of_shift[(first_row + i) % stride]]++;
+		std::copy(rows.begin() + i*num_cols, rows.begin() + (i+1)*num_cols, send_buffer.begin() + position*num_cols);
+	}
+
+	MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, group_peers);
+	for (int p = 1; p < num_peers; p++) recv_displs[p] = recv_displs[p-1] + recv_counts[p-1];
+
+	MPI_Datatype row_type;
+	MPI_Type_contiguous((int) num_cols, MPI_DOUBLE, &row_type);
+	MPI_Type_commit(&row_type);
+
+	vector<double> recv_buffer((uint64_t) (recv_displs[num_peers-1] + recv_counts[num_peers-1])*num_cols);
+	MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displs.data(), row_type,
+			recv_buffer.data(), recv_counts.data(), recv_displs.data(), row_type, group_peers);
+
+	MPI_Type_free(&row_type);
+
+	// Rows from each worker are those of its block that this worker owns, in order
+	double * data = M->Matrix().Buffer();
+	El::Int ldim = M->Matrix().LDim();
+	const double * row = recv_buffer.data();
+
+	for (int p = 0; p < num_peers; p++) {
+		uint64_t begin = blocks[2*p], end = blocks[2*p] + blocks[2*p+1];
+		uint64_t global_row = begin + (shift + stride - begin % stride) % stride;
+
+		for ( ; global_row < end; global_row += stride, row += num_cols) {
+			El::Int i = (El::Int) ((global_row - shift)/stride);
+			for (uint64_t j = 0; j < num_cols; j++) data[i + j*ldim] = row[j];
+		}
+	}
+}
+
+// Reports the dimensions of a matrix about to be read from a file to the driver (zeros if it cannot be read) and
+// returns the ID the driver gives it, or 0
+ArrayID GroupWorker::register_file_matrix(uint64_t dims[2])
+{
+	if (primary_group_worker) MPI_Send(dims, 2, MPI_UNSIGNED_LONG, 0, 0, group);
+
+	ArrayID matrixID;
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+
+	return matrixID;
+}
+
+// Tells the driver whether all of the workers read their rows of a matrix registered by register_file_matrix. The
+// matrix is only kept, and its layout sent to the driver, if they all did; otherwise the driver drops it as well.
+bool GroupWorker::finish_file_matrix(const ArrayID matrixID, DistMatrix_ptr M, int success)
+{
+	MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, group_peers);
+	if (primary_group_worker) MPI_Send(&success, 1, MPI_INT, 0, 0, group);
+
+	if (!success) {
+		log->info("{} Dropping matrix {}: Not all workers could read their rows", client_preamble(), matrixID);
+		return false;
+	}
+
+	matrices.insert(std::make_pair(matrixID, M));
+	get_matrix_layout();
+
+	return true;
+}
+
+// Writes or reads the local rows of a [VR,STAR] matrix to or from a file of rows starting at data_offset, in chunks of rows so that only a
+// chunk has to be transposed between the column-major local matrix and the row-major file at a time. The file view
+// leaves out the rows of the other workers, so each chunk is a single collective call.
+bool GroupWorker::transfer_matrix_rows(MPI_File & file, DistMatrix_ptr M, const MPI_Offset data_offset, const bool write)
+{
+	El::Int num_local_rows = M->LocalHeight();
+	El::Int num_cols = M->Width();
+	if (num_cols == 0) return true;
+
+	MPI_Datatype row_type, rows_type;
+	MPI_Type_contiguous((int) num_cols, MPI_DOUBLE, &row_type);
+	MPI_Type_commit(&row_type);
+	// Workers without rows access nothing, but still need a non-empty file type for the collective calls
+	MPI_Type_vector((int) std::max(num_local_rows, (El::Int) 1), 1, (int) M->ColStride(), row_type, &rows_type);
+	MPI_Type_commit(&rows_type);
+
+	MPI_Offset offset = data_offset + ((MPI_Offset) M->ColShift())*num_cols*sizeof(double);
+	bool success = (MPI_File_set_view(file, offset, row_type, rows_type, "native", MPI_INFO_NULL) == MPI_SUCCESS);
+
+	El::Int chunk_rows = std::max((El::Int) MATRIX_FILE_CHUNK_BYTES/(num_cols*((El::Int) sizeof(double))), (El::Int) 1);
+	int num_chunks = (int) ((num_local_rows + chunk_rows - 1)/chunk_rows);
+	MPI_Allreduce(MPI_IN_PLACE, &num_chunks, 1, MPI_INT, MPI_MAX, group_peers);
+
+	vector<double> rows(std::min(chunk_rows, std::max(num_local_rows, (El::Int) 1))*num_cols);
+	double * data = M->Matrix().Buffer();
+	El::Int ldim = M->Matrix().LDim();
+	MPI_Status status;
+
+	for (int c = 0; c < num_chunks; c++) {
+		El::Int first_row = c*chunk_rows;
+		El::Int num_rows = std::max(std::min(chunk_rows, num_local_rows - first_row), (El::Int) 0);
+
+		if (write) {
+			for (El::Int i = 0; i < num_rows; i++)
+				for (El::Int j = 0; j < num_cols; j++) rows[i*num_cols + j] = data[first_row + i + j*ldim];
+
+			success &= (MPI_File_write_all(file, rows.data(), (int) num_rows, row_type, &status) == MPI_SUCCESS);
+		}
+		else {
+			// Reads past the end of the file succeed with fewer rows
+			int count = 0;
+			success &= (MPI_File_read_all(file, rows.data(), (int) num_rows, row_type, &status) == MPI_SUCCESS);
+			success &= (MPI_Get_count(&status, row_type, &count) == MPI_SUCCESS && count == (int) num_rows);
+
+			for (El::Int i = 0; i < num_rows; i++)
+				for (El::Int j = 0; j < num_cols; j++) data[first_row + i + j*ldim] = rows[i*num_cols + j];
+		}
+	}
+
+	MPI_Type_free(&rows_type);
+	MPI_Type_free(&row_type);
+
+	return success;
+}
+
+// Writes a matrix to a matrix file (see utility/matrix_file.hpp) that LOAD_MATRIX_FILE reads back
+int GroupWorker::save_matrix()
+{
+	ArrayID matrixID;
+	uint16_t file_name_length;
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&file_name_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	char file_name_c[file_name_length+1];
+	MPI_Bcast(file_name_c, file_name_length+1, MPI_CHAR, 0, group);
+
+	string file_name = string(file_name_c);
+
+	DistMatrix_ptr M = get_matrix(matrixID);
+
+	// Rows have to be spread over the workers the way the file view expects
+	if (M->ColDist() != El::VR || M->RowDist() != El::STAR) {
+		DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(M->Grid());
+		El::Copy(*M, *C);
+		M = C;
+	}
+
+	std::clock_t start = std::clock();
+
+	MPI_File file;
+	int success = (MPI_File_open(group_peers, file_name.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file) == MPI_SUCCESS);
+
+	if (success) {
+		MPI_File_set_size(file, 0);
+
+		if (primary_group_worker) {
+			MatrixFileHeader header((uint64_t) M->Height(), (uint64_t) M->Width());
+			MPI_Status status;
+			success = (MPI_File_write_at(file, 0, &header, sizeof(MatrixFileHeader), MPI_BYTE, &status) == MPI_SUCCESS);
+		}
+
+		success &= transfer_matrix_rows(file, M, sizeof(MatrixFileHeader), true);
+		MPI_File_close(&file);
+	}
+
+	MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, group_peers);
+	if (primary_group_worker) MPI_Send(&success, 1, MPI_INT, 0, 0, group);
+
+	if (success)
+		log->info("{} Wrote {} rows of matrix {} to {} in {}ms", client_preamble(), M->LocalHeight(), matrixID, file_name,
+				1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+	else log->info("{} Unable to write matrix {} to {}", client_preamble(), matrixID, file_name);
+
+	return 0;
+}
+
+// Writes the local buffer of a matrix to this worker's snapshot file (see utility/matrix_snapshot.hpp)
+int GroupWorker::save_snapshot()
+{
+	ArrayID matrixID;
+	uint16_t path_length;
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&path_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	char path_c[path_length+1];
+	MPI_Bcast(path_c, path_length+1, MPI_CHAR, 0, group);
+
+	string path = string(path_c);
+
+	DistMatrix_ptr M = get_matrix(matrixID);
+
+	// Snapshots are always [VR,STAR], so that they can be read back onto a grid of a different size
+	if (M->ColDist() != El::VR || M->RowDist() != El::STAR) {
+		DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(M->Grid());
+		El::Copy(*M, *C);
+		M = C;
+	}
+
+	std::clock_t start = std::clock();
+
+	MatrixSnapshotHeader header;
+	memcpy(header.magic, "ALCHSNAP", 8);
+	header.version = MATRIX_SNAPSHOT_VERSION;
+	header.data_offset = MATRIX_SNAPSHOT_DATA_OFFSET;
+	header.num_rows = (uint64_t) M->Height();
+	header.num_cols = (uint64_t) M->Width();
+	header.num_local_rows = (uint64_t) M->LocalHeight();
+	header.num_local_cols = (uint64_t) M->LocalWidth();
+	header.grid_size = (uint32_t) M->Grid().Size();
+	header.grid_height = (uint32_t) M->Grid().Height();
+	header.grid_rank = (uint32_t) M->Grid().VRRank();
+	header.col_dist = (uint8_t) M->ColDist();
+	header.row_dist = (uint8_t) M->RowDist();
+	header.dt = (uint8_t) DOUBLE;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	header.little_endian = 1;
+#endif
+	header.col_align = (uint32_t) M->ColAlign();
+	header.row_align = (uint32_t) M->RowAlign();
+
+	string file_name = get_snapshot_file_name(path, M->Grid().VRRank());
+	int success = 0;
+
+	int fd = ::open(file_name.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+	if (fd >= 0) {
+		success = (pwrite(fd, &header, sizeof(MatrixSnapshotHeader), 0) == (ssize_t) sizeof(MatrixSnapshotHeader));
+
+		// Columns are written back to back, dropping any padding of the local buffer
+		El::Matrix<double> & local = M->Matrix();
+		size_t column_length = 8*header.num_local_rows;
+		off_t offset = MATRIX_SNAPSHOT_DATA_OFFSET;
+
+		if (local.LDim() == local.Height())
+			success &= (pwrite(fd, local.Buffer(), column_length*header.num_local_cols, offset) == (ssize_t) (column_length*header.num_local_cols));
+		else
+			for (El::Int j = 0; j < local.Width(); j++, offset += column_length)
+				success &= (pwrite(fd, local.Buffer(0, j), column_length, offset) == (ssize_t) column_length);
+
+		success &= (ftruncate(fd, MATRIX_SNAPSHOT_DATA_OFFSET + header.data_length()) == 0);
+		success &= (::close(fd) == 0);
+	}
+
+	MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, group_peers);
+	if (primary_group_worker) MPI_Send(&success, 1, MPI_INT, 0, 0, group);
+
+	if (success)
+		log->info("{} Wrote snapshot of matrix {} to {} in {}ms", client_preamble(), matrixID, file_name,
+				1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+	else log->info("{} Unable to write snapshot of matrix {} to {}", client_preamble(), matrixID, file_name);
+
+	return 0;
+}
+
+// Reloads a matrix from a snapshot. If the snapshot was taken on a grid like the current one, each worker maps its own
+// file and the matrix is attached to the mapping, so nothing is read until it is used. Otherwise every worker maps all
+// of the files and copies out the rows it owns under the current grid.
+int GroupWorker::load_snapshot()
+{
+	uint16_t path_length;
+
+	MPI_Bcast(&path_length, 1, MPI_UNSIGNED_SHORT, 0, group);
+	char path_c[path_length+1];
+	MPI_Bcast(path_c, path_length+1, MPI_CHAR, 0, group);
+
+	string path = string(path_c);
+
+	std::clock_t start = std::clock();
+
+	int little_endian = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	little_endian = 1;
+#endif
+
+	// A file has to hold exactly the rows that rank k owns in a [VR,STAR] matrix shaped and aligned like the one in the
+	// first file, since rows are addressed by their position alone
+	auto valid_file = [little_endian](const MatrixSnapshotHeader & h, const MatrixSnapshotHeader & first, const uint32_t k) {
+		if (first.grid_size == 0) return false;
+
+		uint64_t num_files = (uint64_t) first.grid_size;
+		uint64_t shift = (k + num_files - first.col_align % num_files) % num_files;
+		uint64_t num_local_rows = (first.num_rows > shift) ? (first.num_rows - shift - 1)/num_files + 1 : 0;
+
+		return h.col_dist == (uint8_t) El::VR && h.row_dist == (uint8_t) El::STAR && h.dt == (uint8_t) DOUBLE &&
+				h.little_endian == little_endian && h.num_rows == first.num_rows && h.num_cols == first.num_cols &&
+				h.grid_size == first.grid_size && h.grid_rank == k && h.col_align == first.col_align &&
+				h.num_local_rows == num_local_rows && h.num_local_cols == h.num_cols;
+	};
+
+	MappedSnapshot_ptr snapshot = std::make_shared<MappedSnapshot>();
+	const MatrixSnapshotHeader & header = snapshot->header;
+
+	int same_grid = snapshot->open(get_snapshot_file_name(path, grid->VRRank())) &&
+			header.grid_size == (uint32_t) grid->Size() && header.grid_height == (uint32_t) grid->Height() &&
+			valid_file(header, header, (uint32_t) grid->VRRank());
+
+	// The files of the other ranks have to describe the same matrix
+	uint64_t shape[3] = {header.num_rows, header.num_cols, header.col_align};
+	uint64_t min_shape[3], max_shape[3];
+	MPI_Allreduce(shape, min_shape, 3, MPI_UNSIGNED_LONG, MPI_MIN, group_peers);
+	MPI_Allreduce(shape, max_shape, 3, MPI_UNSIGNED_LONG, MPI_MAX, group_peers);
+	same_grid &= (min_shape[0] == max_shape[0] && min_shape[1] == max_shape[1] && min_shape[2] == max_shape[2]);
+	MPI_Allreduce(MPI_IN_PLACE, &same_grid, 1, MPI_INT, MPI_MIN, group_peers);
+
+	int readable = same_grid;
+	vector<MappedSnapshot_ptr> files;
+
+	if (!same_grid) {
+		snapshot->close();
+
+		files.push_back(std::make_shared<MappedSnapshot>());
+		const MatrixSnapshotHeader & first = files[0]->header;
+		readable = files[0]->open(get_snapshot_file_name(path, 0)) && valid_file(first, first, 0);
+
+		for (uint32_t k = 1; readable && k < first.grid_size; k++) {
+			files.push_back(std::make_shared<MappedSnapshot>());
+			readable = files[k]->open(get_snapshot_file_name(path, k)) && valid_file(files[k]->header, first, k);
+		}
+
+		MPI_Allreduce(MPI_IN_PLACE, &readable, 1, MPI_INT, MPI_MIN, group_peers);
+	}
+
+	uint64_t dims[2] = {0, 0};
+	if (readable) {
+		dims[0] = same_grid ? header.num_rows : files[0]->header.num_rows;
+		dims[1] = same_grid ? header.num_cols : files[0]->header.num_cols;
+	}
+	else log->info("{} Unable to read snapshot {}", client_preamble(), path);
+
+	ArrayID matrixID = register_file_matrix(dims);
+
+	if (matrixID > 0) {
+		El::Int num_rows = (El::Int) dims[0], num_cols = (El::Int) dims[1];
+		DistMatrix_ptr M;
+
+		if (same_grid) {
+			El::DistMatrix<double, El::VR, El::STAR> * A = new El::DistMatrix<double, El::VR, El::STAR>(*grid);
+			A->Attach(num_rows, num_cols, *grid, (int) header.col_align, (int) header.row_align, snapshot->data(),
+					std::max((El::Int) header.num_local_rows, (El::Int) 1));
+
+			// The mapping has to outlive the matrix attached to it
+			M = DistMatrix_ptr(A, [snapshot](El::AbstractDistMatrix<double> * A) { delete A; });
+		}
+		else {
+			M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(num_rows, num_cols, *grid);
+
+			// Rows of file k are those congruent to its column shift modulo the number of files
+			El::Int num_files = (El::Int) files.size();
+			vector<uint32_t> file_of_shift(num_files);
+			for (El::Int k = 0; k < num_files; k++)
+				file_of_shift[(k + num_files - files[k]->header.col_align % num_files) % num_files] = (uint32_t) k;
+
+			double * data = M->Matrix().Buffer();
+			El::Int ldim = M->Matrix().LDim();
+
+			for (El::Int i = 0; i < M->LocalHeight(); i++) {
+				El::Int row = M->GlobalRow(i);
+
+				const MappedSnapshot_ptr & file = files[file_of_shift[row % num_files]];
+				El::Int file_ldim = std::max((El::Int) file->header.num_local_rows, (El::Int) 1);
+				const double * file_row = file->data() + row/num_files;
+
+				for (El::Int j = 0; j < num_cols; j++) data[i + j*ldim] = file_row[j*file_ldim];
+			}
+		}
+
+		log->info("{} {} {} rows of matrix {} from snapshot {} in {}ms", client_preamble(), same_grid ? "Mapped" : "Copied",
+				M->LocalHeight(), matrixID, path, 1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+		finish_file_matrix(matrixID, M, 1);
+	}
+
+	return 0;
+}
+
+// Reads a 1D or 2D dataset into a new [VR,STAR] matrix. The file is opened with MPI-IO on the workers' communicator
+// and each worker reads its rows, a strided hyperslab, in one collective read; the rows are then transposed into the
+// column-major local matrix.
+int GroupWorker::read_HDF5(const string & file_name, const string & dataset_name)
+{
+	uint64_t dims[2] = {0, 0};
+
+#ifdef ALCHEMIST_HDF5
+	hid_t file = -1, dataset = -1, filespace = -1;
+	int ndims = 0;
+
+	hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+	H5Pset_fapl_mpio(fapl, group_peers, MPI_INFO_NULL);
+	file = H5Fopen(file_name.c_str(), H5F_ACC_RDONLY, fapl);
+	H5Pclose(fapl);
+
+	if (file >= 0) dataset = H5Dopen2(file, dataset_name.c_str(), H5P_DEFAULT);
+	if (dataset >= 0) {
+		filespace = H5Dget_space(dataset);
+		ndims = H5Sget_simple_extent_ndims(filespace);
+	}
+
+	if (ndims == 1 || ndims == 2) {
+		hsize_t file_dims[2] = {1, 1};
+		H5Sget_simple_extent_dims(filespace, file_dims, nullptr);
+		dims[0] = (uint64_t) file_dims[0];
+		dims[1] = (uint64_t) file_dims[1];
+	}
+
+	// All workers have to be able to read the dataset
+	int readable = (dims[0] > 0 && dims[1] > 0) ? 1 : 0;
+	MPI_Allreduce(MPI_IN_PLACE, &readable, 1, MPI_INT, MPI_MIN, group_peers);
+	if (!readable) {
+		log->info("{} Unable to read dataset {} of {}", client_preamble(), dataset_name, file_name);
+		dims[0] = dims[1] = 0;
+	}
+#else
+	log->info("{} Unable to read {}: Alchemist was built without HDF5 support", client_preamble(), file_name);
+#endif
+
+	ArrayID matrixID = register_file_matrix(dims);
+	DistMatrix_ptr M;
+	int success = 0;
+
+#ifdef ALCHEMIST_HDF5
+	if (matrixID > 0) {
+		El::Int num_rows = (El::Int) dims[0], num_cols = (El::Int) dims[1];
+
+		M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(num_rows, num_cols, *grid);
+		El::Int num_local_rows = M->LocalHeight();
+
+		hsize_t start[2] = {(hsize_t) M->ColShift(), 0};
+		hsize_t stride[2] = {(hsize_t) M->ColStride(), 1};
+		hsize_t count[2] = {(hsize_t) num_local_rows, 1};
+		hsize_t block[2] = {1, (hsize_t) num_cols};
+
+		if (num_local_rows > 0) H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, stride, count, block);
+		else H5Sselect_none(filespace);
+
+		// Workers without rows still take part in the collective read
+		hsize_t num_local_values = (hsize_t) std::max(num_local_rows*num_cols, (El::Int) 1);
+		hid_t memspace = H5Screate_simple(1, &num_local_values, nullptr);
+		if (num_local_rows == 0) H5Sselect_none(memspace);
+
+		vector<double> rows(num_local_values);
+
+		hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+		H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+
+		// HDF5 converts other numeric types to double
+		success = (H5Dread(dataset, H5T_NATIVE_DOUBLE, memspace, filespace, dxpl, rows.data()) >= 0);
+		if (!success) log->info("{} Error while reading dataset {} of {}", client_preamble(), dataset_name, file_name);
+
+		H5Pclose(dxpl);
+		H5Sclose(memspace);
+
+		double * data = M->Matrix().Buffer();
+		El::Int ldim = M->Matrix().LDim();
+		for (El::Int i = 0; i < num_local_rows; i++)
+			for (El::Int j = 0; j < num_cols; j++) data[i + j*ldim] = rows[i*num_cols + j];
+
+		if (success) log->info("{} Read {} rows of matrix {} from {}", client_preamble(), num_local_rows, matrixID, file_name);
+	}
+
+	if (filespace >= 0) H5Sclose(filespace);
+	if (dataset >= 0) H5Dclose(dataset);
+	if (file >= 0) H5Fclose(file);
+#endif
+
+	if (matrixID > 0) finish_file_matrix(matrixID, M, success);
 
 	return 0;
 }
@@ -108,7 +989,15 @@ int GroupWorker::wait_for_command()
 			std::this_thread::sleep_for(std::chrono::milliseconds(200));
 		}
 
-		threads.push_back(std::thread(&GroupWorker::handle_command, this, c));
+		// Freeing the group ends this loop, so that the worker can take part in the next group
+		if (c == _AM_FREE_GROUP) {
+			for (auto & t: threads) t.join();
+			threads.clear();
+
+			handle_free_group();
+			should_exit = true;
+		}
+		else threads.push_back(std::thread(&GroupWorker::handle_command, this, c));
 
 		flag = 0;
 		c = _AM_IDLE;
@@ -117,12 +1006,20 @@ int GroupWorker::wait_for_command()
 	}
 
 	for (auto & t: threads) t.join();
+	threads.clear();
 
 	return 0;
 }
 
 void GroupWorker::handle_free_group()
 {
+	// Cached communicators (and the grid on top of them) are kept for the next group with the same workers
+	if (group_comms_cached) {
+		group = MPI_COMM_NULL;
+		group_peers = MPI_COMM_NULL;
+		return;
+	}
+
 	if (group != MPI_COMM_NULL) {
 		MPI_Barrier(group);
 
@@ -175,6 +1072,39 @@ int GroupWorker::handle_command(alchemist_command c)
 		case _AM_WORKER_RUN_TASK:
 			run_task();
 			break;
+		case _AM_LOAD_MATRIX_FILE:
+			load_matrix_file();
+			break;
+		case _AM_SAVE_MATRIX:
+			save_matrix();
+			break;
+		case _AM_SAVE_SNAPSHOT:
+			save_snapshot();
+			break;
+		case _AM_LOAD_SNAPSHOT:
+			load_snapshot();
+			break;
+		case _AM_MATRIX_TRANSPOSE:
+			get_transpose();
+			break;
+		case _AM_MATRIX_MULTIPLY:
+			matrix_multiply();
+			break;
+		case _AM_MATRIX_ROWS:
+			get_matrix_rows();
+			break;
+		case _AM_MATRIX_VIEW:
+			create_view();
+			break;
+		case _AM_MATRIX_EXPRESSION:
+			evaluate_expression();
+			break;
+		case _AM_MATRIX_STATS:
+			get_matrix_stats();
+			break;
+		case _AM_GENERATE_MATRIX:
+			generate_matrix();
+			break;
 	}
 
 	return 0;
@@ -302,6 +1232,9 @@ int GroupWorker::load_library()
 	char library_path_c[library_path_length+1];
 	MPI_Bcast(library_path_c, library_path_length+1, MPI_CHAR, 0, group);
 
+	uint8_t workers_only;
+	MPI_Bcast(&workers_only, 1, MPI_UNSIGNED_CHAR, 0, group);
+
 	MPI_Barrier(group);
 
 	string library_name = string(library_name_c);
@@ -330,7 +1263,8 @@ int GroupWorker::load_library()
 		return 0;
 	}
 
-	Library * library_ptr = reinterpret_cast<Library*>(create_library(group));
+	// Without the driver the library runs on the workers' communicator, with the primary group worker as rank 0
+	Library * library_ptr = reinterpret_cast<Library*>(create_library(workers_only ? group_peers : group));
 
 	libraries.insert(std::make_pair(libraryID, library_ptr));
 
@@ -419,7 +1353,7 @@ void GroupWorker::read_matrix_parameters(Parameters & output_parameters)
 			MPI_Bcast(&matrixIDs[i], 1, MPI_UNSIGNED_SHORT, 0, group);
 			MPI_Barrier(group);
 
-			distmatrix_ptr = matrices[matrixIDs[i]];
+			distmatrix_ptr = get_matrix(matrixIDs[i]);
 			uint64_t num_local_rows = (uint64_t) distmatrix_ptr->LocalHeight();
 			uint64_t * local_rows = new uint64_t[num_local_rows];
 
@@ -444,51 +1378,499 @@ int GroupWorker::get_matrix_layout()
 	MPI_Bcast(&ID, 1, MPI_UNSIGNED_SHORT, 0, group);
 	MPI_Barrier(group);
 
-	DistMatrix_ptr matrix = matrices[ID];
-	uint64_t num_local_rows = (uint64_t) matrix->LocalHeight();
-	uint64_t * local_rows = new uint64_t[num_local_rows];
+	vector<uint64_t> view_rows;
+	auto view = views.find(ID);
 
-	for (uint64_t i = 0; i < num_local_rows; i++) local_rows[i] = (uint64_t) matrix->GlobalRow(i);
+	// Rows of a view that has not been materialized yet are on the workers holding the corresponding rows of its parent
+	if (view != views.end()) {
+		DistMatrix_ptr parent = get_matrix(view->second.parentID);
+		for (uint64_t i = 0; view->second.rows[0] + i < view->second.rows[1]; i++)
+			if (parent->IsLocalRow((El::Int) (view->second.rows[0] + i))) view_rows.push_back(i);
+	}
+	else {
+		DistMatrix_ptr matrix = get_matrix(ID);
+		for (El::Int i = 0; i < matrix->LocalHeight(); i++) view_rows.push_back((uint64_t) matrix->GlobalRow(i));
+	}
+
+	uint64_t num_local_rows = (uint64_t) view_rows.size();
+	uint64_t * local_rows = view_rows.data();
 
 	MPI_Send(&num_local_rows, 1, MPI_UNSIGNED_LONG, 0, 0, group);
 	MPI_Send(local_rows, (int) num_local_rows, MPI_UNSIGNED_LONG, 0, 0, group);
 
-	delete [] local_rows;
-
 	MPI_Barrier(group);
 
 	return 0;
 }
 
+// Matrices are looked up through here so that views are materialized on first use. Only views whose rows stay on the
+// workers holding them in the parent are kept unmaterialized, so no other worker has to take part.
+DistMatrix_ptr GroupWorker::get_matrix(ArrayID ID)
+{
+	auto it = matrices.find(ID);
+	if (it != matrices.end()) return it->second;
+
+	std::lock_guard<std::mutex> lock(view_mutex);
+
+	it = matrices.find(ID);
+	if (it != matrices.end()) return it->second;
+
+	auto view = views.find(ID);
+	if (view == views.end()) return nullptr;
+
+	DistMatrix_ptr M = materialize_view(view->second);
+	matrices.insert(std::make_pair(ID, M));
+	views.erase(view);
+
+	return M;
+}
+
+// A view of whole columns is an Elemental view of the parent and shares its storage; any other selection of columns
+// is copied into a matrix aligned with the parent, which only involves local rows
+DistMatrix_ptr GroupWorker::materialize_view(const MatrixView & view)
+{
+	DistMatrix_ptr parent = matrices[view.parentID];
+
+	El::Int row_start = (El::Int) view.rows[0], row_end = (El::Int) view.rows[1];
+	El::Int col_start = (El::Int) view.cols[0], col_end = (El::Int) view.cols[1], col_stride = (El::Int) view.cols[2];
+	El::Int num_cols = (col_end - col_start + col_stride - 1)/col_stride;
+
+	// The parent has to outlive any view of it
+	El::DistMatrix<double, El::VR, El::STAR> * V = new El::DistMatrix<double, El::VR, El::STAR>(parent->Grid());
+	DistMatrix_ptr rows = DistMatrix_ptr(V, [parent](El::AbstractDistMatrix<double> * A) { delete A; });
+
+	if (col_stride == 1) {
+		El::View(*V, *parent, El::IR(row_start, row_end), El::IR(col_start, col_end));
+		return rows;
+	}
+
+	El::View(*V, *parent, El::IR(row_start, row_end), El::IR(0, parent->Width()));
+
+	DistMatrix_ptr M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(parent->Grid());
+	M->Align(V->ColAlign(), 0);
+	M->Resize(row_end - row_start, num_cols);
+
+	El::Matrix<double> & source = V->Matrix();
+	El::Matrix<double> & target = M->Matrix();
+	for (El::Int j = 0; j < num_cols; j++)
+		memcpy(target.Buffer(0, j), source.Buffer(0, col_start + j*col_stride), 8*target.Height());
+
+	return M;
+}
+
+// Evaluates an elementwise expression (see utility/expression.hpp) over the local rows of its operands, either into a new
+// matrix or into an existing one. Operands are brought into the [VR,STAR] layout of the first one if they are not in it
+// already, after which every worker works on its own rows only; column reductions are the only communication.
+int GroupWorker::evaluate_expression()
+{
+	uint16_t header[3];			// Result, whether the result is an existing matrix, number of operands
+	uint32_t expression_length;
+
+	MPI_Bcast(header, 3, MPI_UNSIGNED_SHORT, 0, group);
+	vector<ArrayID> operandIDs(header[2]);
+	MPI_Bcast(operandIDs.data(), (int) header[2], MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&expression_length, 1, MPI_UNSIGNED, 0, group);
+	vector<char> expression_c(expression_length+1);
+	MPI_Bcast(expression_c.data(), (int) expression_length+1, MPI_CHAR, 0, group);
+
+	ArrayID resultID = header[0];
+	bool in_place = (header[1] != 0);
+	string text = string(expression_c.data());
+
+	std::clock_t start = std::clock();
+
+	Expression expression;
+	string error;
+	expression.compile(text, operandIDs.size(), error);
+
+	vector<DistMatrix_ptr> operands;
+	for (ArrayID ID : operandIDs) {
+		DistMatrix_ptr A = get_matrix(ID);
+
+		if (A->ColDist() != El::VR || A->RowDist() != El::STAR || (!operands.empty() && A->ColAlign() != operands[0]->ColAlign())) {
+			DistMatrix_ptr B = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(*grid);
+			if (!operands.empty()) B->Align(operands[0]->ColAlign(), 0);
+			El::Copy(*A, *B);
+			A = B;
+		}
+		operands.push_back(A);
+	}
+
+	El::Int num_rows = operands[0]->Height(), num_cols = operands[0]->Width();
+	El::Int num_local_rows = operands[0]->LocalHeight();
+
+	// The result can be written straight into an existing matrix that has the same layout as the operands
+	DistMatrix_ptr target = in_place ? get_matrix(resultID) : nullptr;
+	DistMatrix_ptr C = target;
+	if (C == nullptr || C->ColDist() != El::VR || C->RowDist() != El::STAR || C->ColAlign() != operands[0]->ColAlign()) {
+		C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(*grid);
+		C->Align(operands[0]->ColAlign(), 0);
+		C->Resize(num_rows, num_cols);
+	}
+
+	// Column reductions, one row of values per reduction
+	size_t num_reductions = expression.reductions.size();
+	vector<double> reduction_values(num_reductions*num_cols);
+
+	for (size_t r = 0; r < num_reductions; r++) {
+		const El::Matrix<double> & A = operands[expression.reductions[r].operand]->LockedMatrix();
+		column_reduction reduction = expression.reductions[r].reduction;
+		double * values = reduction_values.data() + r*num_cols;
+
+		#pragma omp parallel for schedule(static)
+		for (El::Int j = 0; j < num_cols; j++) {
+			const double * column = A.LockedBuffer() + j*A.LDim();
+			double value = (reduction == COLUMN_MIN) ? INFINITY : ((reduction == COLUMN_MAX) ? -INFINITY : 0.0);
+			for (El::Int i = 0; i < num_local_rows; i++) {
+				if (reduction == COLUMN_MIN) value = std::min(value, column[i]);
+				else if (reduction == COLUMN_MAX) value = std::max(value, column[i]);
+				else value += column[i];
+			}
+			values[j] = value;
+		}
+
+		MPI_Op op = (reduction == COLUMN_MIN) ? MPI_MIN : ((reduction == COLUMN_MAX) ? MPI_MAX : MPI_SUM);
+		MPI_Allreduce(MPI_IN_PLACE, values, (int) num_cols, MPI_DOUBLE, op, group_peers);
+
+		if (reduction == COLUMN_MEAN || reduction == COLUMN_STD)
+			for (El::Int j = 0; j < num_cols; j++) values[j] /= (double) num_rows;
+
+		// Deviations from the mean take a second pass, which is more accurate than summing squares in the first
+		if (reduction == COLUMN_STD) {
+			vector<double> deviations(num_cols, 0.0);
+
+			#pragma omp parallel for schedule(static)
+			for (El::Int j = 0; j < num_cols; j++) {
+				const double * column = A.LockedBuffer() + j*A.LDim();
+				double sum = 0.0;
+				for (El::Int i = 0; i < num_local_rows; i++) sum += (column[i] - values[j])*(column[i] - values[j]);
+				deviations[j] = sum;
+			}
+
+			MPI_Allreduce(MPI_IN_PLACE, deviations.data(), (int) num_cols, MPI_DOUBLE, MPI_SUM, group_peers);
+			for (El::Int j = 0; j < num_cols; j++) values[j] = std::sqrt(deviations[j]/(double) num_rows);
+		}
+	}
+
+	// A single pass over the operands, a chunk of rows of one column at a time
+	El::Int num_chunks = (num_local_rows + EXPRESSION_CHUNK - 1)/EXPRESSION_CHUNK;
+	size_t num_operands = operands.size();
+
+	#pragma omp parallel
+	{
+		vector<double> stack(expression.max_depth*EXPRESSION_CHUNK);
+		vector<const double *> columns(num_operands);
+
+		#pragma omp for collapse(2) schedule(static)
+		for (El::Int j = 0; j < num_cols; j++)
+			for (El::Int c = 0; c < num_chunks; c++) {
+				El::Int first_row = c*EXPRESSION_CHUNK;
+				size_t n = (size_t) std::min((El::Int) EXPRESSION_CHUNK, num_local_rows - first_row);
+
+				for (size_t k = 0; k < num_operands; k++) {
+					const El::Matrix<double> & A = operands[k]->LockedMatrix();
+					columns[k] = A.LockedBuffer() + first_row + j*A.LDim();
+				}
+
+				El::Matrix<double> & local = C->Matrix();
+				expression.evaluate(columns.data(), reduction_values.data() + j, (size_t) num_cols,
+						local.Buffer() + first_row + j*local.LDim(), n, stack.data());
+			}
+	}
+
+	if (in_place && C != target) El::Copy(*C, *target);
+	if (!in_place) matrices.insert(std::make_pair(resultID, C));
+
+	log->info("{} Evaluated '{}' into matrix {} in {}ms", client_preamble(), text, resultID,
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+	if (!in_place) get_matrix_layout();
+
+	return 0;
+}
+
+// Summarizes each column of a matrix (see utility/column_stats.hpp) in one pass over the local rows, with the rows split
+// into a block per thread, and combines the summaries of all workers with a single reduction. Only the primary group
+// worker sends the result to the driver.
+int GroupWorker::get_matrix_stats()
+{
+	ArrayID matrixID;
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+
+	std::clock_t start = std::clock();
+
+	DistMatrix_ptr A = get_matrix(matrixID);
+
+	// Each worker has to hold whole rows, and each row has to be on a single worker so that it is only counted once
+	if (A->ColDist() != El::VR || A->RowDist() != El::STAR) {
+		DistMatrix_ptr B = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(*grid);
+		El::Copy(*A, *B);
+		A = B;
+	}
+
+	const El::Matrix<double> & local = A->LockedMatrix();
+	El::Int num_local_rows = local.Height(), num_cols = local.Width();
+	El::Int num_blocks = std::max(std::min((El::Int) omp_get_max_threads(), num_local_rows), (El::Int) 1);
+	El::Int block_size = (num_local_rows + num_blocks - 1)/num_blocks;
+
+	vector<ColumnStats> block_stats(num_cols*num_blocks);
+
+	#pragma omp parallel for collapse(2) schedule(static)
+	for (El::Int j = 0; j < num_cols; j++)
+		for (El::Int b = 0; b < num_blocks; b++) {
+			const double * column = local.LockedBuffer() + j*local.LDim();
+			ColumnStats & stats = block_stats[j*num_blocks + b];
+			for (El::Int i = b*block_size; i < std::min((b+1)*block_size, num_local_rows); i++) stats.add(column[i]);
+		}
+
+	vector<ColumnStats> stats(num_cols);
+	for (El::Int j = 0; j < num_cols; j++)
+		for (El::Int b = 0; b < num_blocks; b++) stats[j].merge(block_stats[j*num_blocks + b]);
+
+	MPI_Datatype stats_type;
+	MPI_Op merge_op;
+	MPI_Type_contiguous(sizeof(ColumnStats)/sizeof(double), MPI_DOUBLE, &stats_type);
+	MPI_Type_commit(&stats_type);
+	MPI_Op_create(merge_column_stats, 1, &merge_op);
+
+	MPI_Allreduce(MPI_IN_PLACE, stats.data(), (int) num_cols, stats_type, merge_op, group_peers);
+
+	MPI_Op_free(&merge_op);
+	MPI_Type_free(&stats_type);
+
+	if (primary_group_worker)
+		MPI_Send(stats.data(), (int) (num_cols*sizeof(ColumnStats)/sizeof(double)), MPI_DOUBLE, 0, 0, group);
+
+	log->info("{} Computed statistics of matrix {} in {}ms", client_preamble(), matrixID,
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+	return 0;
+}
+
+// Fills a new matrix with random entries (see utility/random_matrix.hpp). Each entry only depends on its global row and
+// column, so the local rows are generated independently, in blocks of rows per thread.
+int GroupWorker::generate_matrix()
+{
+	ArrayID matrixID;
+	uint64_t args[3];				// Rows, columns, seed
+	double params[2];
+	uint8_t dist;
+
+	MPI_Bcast(&matrixID, 1, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(args, 3, MPI_UINT64_T, 0, group);
+	MPI_Bcast(params, 2, MPI_DOUBLE, 0, group);
+	MPI_Bcast(&dist, 1, MPI_UINT8_T, 0, group);
+
+	std::clock_t start = std::clock();
+
+	RandomMatrixGenerator generator((random_distribution) dist, args[2], params[0], params[1], args[0], args[1]);
+
+	DistMatrix_ptr A = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>((El::Int) args[0], (El::Int) args[1], *grid);
+
+	El::Matrix<double> & local = A->Matrix();
+	El::Int num_local_rows = local.Height(), num_cols = local.Width();
+	El::Int num_blocks = std::max(std::min((El::Int) omp_get_max_threads(), num_local_rows), (El::Int) 1);
+	El::Int block_size = (num_local_rows + num_blocks - 1)/num_blocks;
+
+	vector<int64_t> rows(num_local_rows);
+	for (El::Int i = 0; i < num_local_rows; i++) rows[i] = (int64_t) A->GlobalRow(i);
+
+	#pragma omp parallel for collapse(2) schedule(static)
+	for (El::Int j = 0; j < num_cols; j++)
+		for (El::Int b = 0; b < num_blocks; b++) {
+			El::Int first_row = b*block_size;
+			El::Int n = std::min(block_size, num_local_rows - first_row);
+			if (n > 0) generator.fill((uint64_t) j, rows.data() + first_row, (size_t) n, local.Buffer() + j*local.LDim() + first_row);
+		}
+
+	matrices.insert(std::make_pair(matrixID, A));
+	log->info("{} Generated {}x{} {} matrix {} in {}ms", client_preamble(), args[0], args[1],
+			get_random_distribution_name((random_distribution) dist), matrixID,
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+	get_matrix_layout();
+
+	return 0;
+}
+
+// Creates a view of part of a matrix: a range of rows, a range of columns (both possibly strided) and optionally its
+// transpose. Views of consecutive rows of a [VR,STAR] matrix are only recorded here and materialized on first use,
+// without moving any data; anything else needs rows from other workers and is copied into a new matrix right away.
+int GroupWorker::create_view()
+{
+	ArrayID IDs[2];				// Parent, view
+	uint64_t dims[6];			// Start, end (exclusive) and stride of the rows, then of the columns
+	uint8_t transposed;
+
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(dims, 6, MPI_UNSIGNED_LONG, 0, group);
+	MPI_Bcast(&transposed, 1, MPI_UNSIGNED_CHAR, 0, group);
+
+	MatrixView view;
+	view.parentID = IDs[0];
+	std::copy(dims, dims + 3, view.rows);
+	std::copy(dims + 3, dims + 6, view.cols);
+
+	DistMatrix_ptr parent = get_matrix(view.parentID);
+
+	if (!transposed && view.rows[2] == 1 && parent->ColDist() == El::VR && parent->RowDist() == El::STAR) {
+		std::lock_guard<std::mutex> lock(view_mutex);
+		views.insert(std::make_pair(IDs[1], view));
+
+		log->info("{} Created view {} of matrix {}", client_preamble(), IDs[1], IDs[0]);
+	}
+	else {
+		std::clock_t start = std::clock();
+
+		vector<El::Int> row_indices, col_indices;
+		for (uint64_t i = view.rows[0]; i < view.rows[1]; i += view.rows[2]) row_indices.push_back((El::Int) i);
+		for (uint64_t j = view.cols[0]; j < view.cols[1]; j += view.cols[2]) col_indices.push_back((El::Int) j);
+
+		DistMatrix_ptr M = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(*grid);
+		El::GetSubmatrix(*parent, row_indices, col_indices, *M);
+
+		if (transposed) {
+			DistMatrix_ptr T = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(M->Width(), M->Height(), *grid);
+			El::Transpose(*M, *T);
+			M = T;
+		}
+
+		matrices.insert(std::make_pair(IDs[1], M));
+		log->info("{} Copied view {} of matrix {} in {}ms", client_preamble(), IDs[1], IDs[0],
+				1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+	}
+
+	get_matrix_layout();
+
+	return 0;
+}
+
 void GroupWorker::set_value(ArrayID ID, uint64_t row, uint64_t col, float value)
 {
-	matrices[ID]->SetLocal(matrices[ID]->LocalRow(row), matrices[ID]->LocalCol(col), value);
+	DistMatrix_ptr matrix = get_matrix(ID);
+	matrix->SetLocal(matrix->LocalRow(row), matrix->LocalCol(col), value);
 }
 
 void GroupWorker::set_value(ArrayID ID, uint64_t row, uint64_t col, double value)
 {
-	matrices[ID]->SetLocal(matrices[ID]->LocalRow(row), matrices[ID]->LocalCol(col), value);
+	DistMatrix_ptr matrix = get_matrix(ID);
+	matrix->SetLocal(matrix->LocalRow(row), matrix->LocalCol(col), value);
 }
 
 void GroupWorker::get_value(ArrayID ID, uint64_t row, uint64_t col, float & value)
 {
-	value = matrices[ID]->GetLocal(matrices[ID]->LocalRow(row), matrices[ID]->LocalCol(col));
+	DistMatrix_ptr matrix = get_matrix(ID);
+	value = matrix->GetLocal(matrix->LocalRow(row), matrix->LocalCol(col));
 }
 
 void GroupWorker::get_value(ArrayID ID, uint64_t row, uint64_t col, double & value)
 {
 //	clock_t start1 = clock();
-	value = matrices[ID]->GetLocal(matrices[ID]->LocalRow(row), matrices[ID]->LocalCol(col));
+	DistMatrix_ptr matrix = get_matrix(ID);
+	value = matrix->GetLocal(matrix->LocalRow(row), matrix->LocalCol(col));
+}
+
+// Whether a block sent by a client lies inside the matrix, covers only entries held by this worker and has exactly as
+// many elements as its dimensions describe, which is all that the copies below rely on
+bool GroupWorker::check_block(ArrayID ID, const DoubleArrayBlock_ptr & block)
+{
+	DistMatrix_ptr matrix = get_matrix(ID);
+
+	if (matrix == nullptr || block == nullptr || block->ndims != 2) return false;
+
+	const uint64_t * start = block->dims[0], * end = block->dims[1], * skip = block->dims[2];
+
+	if (skip[0] == 0 || skip[1] == 0) return false;
+	if (end[0] > (uint64_t) matrix->Height() || end[1] > (uint64_t) matrix->Width()) return false;
+
+	uint64_t num_rows = (end[0] > start[0]) ? (end[0] - start[0] + skip[0] - 1)/skip[0] : 0;
+	uint64_t num_cols = (end[1] > start[1]) ? (end[1] - start[1] + skip[1] - 1)/skip[1] : 0;
+	if (num_rows*num_cols != block->size) return false;
+
+	for (uint64_t i = start[0]; i < end[0]; i += skip[0])
+		if (!matrix->IsLocalRow((El::Int) i)) return false;
+	for (uint64_t j = start[1]; j < end[1]; j += skip[1])
+		if (!matrix->IsLocalCol((El::Int) j)) return false;
+
+	return true;
+}
+
+// Blocks are copied straight to and from the local column-major buffer; both return false, without copying anything,
+// if the block does not pass check_block
+bool GroupWorker::set_block(ArrayID ID, const DoubleArrayBlock_ptr & block)
+{
+	if (!check_block(ID, block)) return false;
+
+	DistMatrix_ptr matrix = get_matrix(ID);
+
+	double * local_data = matrix->Matrix().Buffer();
+	uint64_t ldim = (uint64_t) matrix->Matrix().LDim();
+	const char * block_data = block->start;
+
+	for (uint64_t i = block->dims[0][0]; i < block->dims[1][0]; i += block->dims[2][0]) {
+		double * local_row = local_data + matrix->LocalRow(i);
+		for (uint64_t j = block->dims[0][1]; j < block->dims[1][1]; j += block->dims[2][1]) {
+			memcpy(local_row + ldim*matrix->LocalCol(j), block_data, 8);
+			block_data += 8;
+		}
+	}
+
+	return true;
+}
+
+bool GroupWorker::get_block(ArrayID ID, const DoubleArrayBlock_ptr & block)
+{
+	if (!check_block(ID, block)) return false;
+
+	DistMatrix_ptr matrix = get_matrix(ID);
+
+	const double * local_data = matrix->LockedMatrix().LockedBuffer();
+	uint64_t ldim = (uint64_t) matrix->LockedMatrix().LDim();
+	char * block_data = block->start;
+
+	for (uint64_t i = block->dims[0][0]; i < block->dims[1][0]; i += block->dims[2][0]) {
+		const double * local_row = local_data + matrix->LocalRow(i);
+		for (uint64_t j = block->dims[0][1]; j < block->dims[1][1]; j += block->dims[2][1]) {
+			memcpy(block_data, local_row + ldim*matrix->LocalCol(j), 8);
+			block_data += 8;
+		}
+	}
+
+	return true;
+}
+
+// A block holding part of a single column whose rows are consecutive local rows can be read straight into the local
+// buffer; returns nullptr for any other block
+double * GroupWorker::get_block_target(ArrayID ID, const DoubleArrayBlock_ptr & block)
+{
+	if (!check_block(ID, block)) return nullptr;
+
+	DistMatrix_ptr matrix = get_matrix(ID);
+
+	uint64_t row_start = block->dims[0][0], row_end = block->dims[1][0], row_skip = block->dims[2][0];
+	uint64_t col = block->dims[0][1];
+
+	if (row_end <= row_start || col + block->dims[2][1] < block->dims[1][1]) return nullptr;
+
+	uint64_t num_rows = block->size;
+	if (num_rows > 1 && row_skip != (uint64_t) matrix->ColStride()) return nullptr;
+
+	uint64_t local_row = (uint64_t) matrix->LocalRow(row_start);
+	if (local_row + num_rows > (uint64_t) matrix->LocalHeight()) return nullptr;
+
+	return matrix->Matrix().Buffer() + local_row + matrix->Matrix().LDim()*matrix->LocalCol(col);
 }
 
 void GroupWorker::print_data(ArrayID ID)
 {
 	std::stringstream ss;
 	ss << "LOCAL DATA:" << std::endl;
-	ss << "Local size: " << matrices[ID]->LocalHeight() << " x " << matrices[ID]->LocalWidth() << std::endl;
-	for (El::Int i = 0; i < matrices[ID]->LocalHeight(); i++) {
-		for (El::Int j = 0; j < matrices[ID]->LocalWidth(); j++)
-			ss <<  matrices[ID]->GetLocal(i, j) << " ";
+	DistMatrix_ptr matrix = get_matrix(ID);
+	ss << "Local size: " << matrix->LocalHeight() << " x " << matrix->LocalWidth() << std::endl;
+	for (El::Int i = 0; i < matrix->LocalHeight(); i++) {
+		for (El::Int j = 0; j < matrix->LocalWidth(); j++)
+			ss <<  matrix->GetLocal(i, j) << " ";
 		ss << std::endl;
 	}
 	log->info(ss.str());
@@ -510,37 +1892,54 @@ bool GroupWorker::check_libraryID(LibraryID & libID)
 
 void GroupWorker::run_task()
 {
-	uint32_t data_length;
-	MPI_Bcast(&data_length, 1, MPI_UNSIGNED, 0, group);
-
-	char * data = new char[data_length];
-	MPI_Bcast(data, data_length, MPI_CHAR, 0, group);
+	uint32_t task_header[5];
+	MPI_Bcast(task_header, 5, MPI_UNSIGNED, 0, group);
+
+	// The body is broadcast straight into the task message, whose buffer is kept from one task to the next, and the
+	// parameters are read from it in place
+	task_msg.clear();
+	task_msg.reserve(task_header[0]);
+	MPI_Bcast(task_msg.body(), task_header[0], MPI_CHAR, 0, group);
+	task_msg.body_length = task_header[0];
+	task_msg.set_client_language((client_language) task_header[1]);
+	task_msg.reverse_floats = (task_header[2] != 0);
+	task_msg.little_endian = (task_header[3] != 0);
 
-	MPI_Barrier(group);
-
-	Message temp_in_msg(data_length), temp_out_msg(data_length);
 	Parameters in, out;
 
-	temp_in_msg.copy_body(&data[0], data_length);
-	MPI_Barrier(group);
-
-	LibraryID libID = temp_in_msg.read_LibraryID();
+	LibraryID libID = task_msg.read_LibraryID();
 
 	if (check_libraryID(libID)) {
-		string function_name = temp_in_msg.read_string();
+		string function_name = task_msg.read_string();
 
-		deserialize_parameters(in, temp_in_msg);
+		deserialize_parameters(in, task_msg);
 
 		libraries[libID]->run(function_name, in, out);
 
 		MPI_Barrier(group);
 
-//		serialize_parameters(out, temp_out_msg);
-
 		read_matrix_parameters(out);
+
+		// Without the driver taking part, the primary group worker returns the output parameters in its place
+		if (task_header[4] != 0 && primary_group_worker) send_task_output(out);
 	}
 }
 
+void GroupWorker::send_task_output(Parameters & output_parameters)
+{
+	output_msg.clear();
+	output_msg.set_client_language(task_msg.cl);
+	output_msg.reverse_floats = task_msg.reverse_floats;
+	output_msg.little_endian = task_msg.little_endian;
+
+	serialize_parameters(output_parameters, output_msg);
+
+	uint32_t output_length = (uint32_t) output_msg.write_pos - Message::header_length;
+
+	MPI_Send(&output_length, 1, MPI_UNSIGNED, 0, 0, group);
+	MPI_Send(output_msg.body(), (int) output_length, MPI_CHAR, 0, 0, group);
+}
+
 // ----------------------------------------   Parameters   ---------------------------------------
 
 int GroupWorker::process_input_parameters(Parameters & input_parameters) {
@@ -613,45 +2012,92 @@ int GroupWorker::receive_new_matrix() {
 	return 0;
 }
 
-int GroupWorker::get_matrix_dimensions() {
+// Built-in operations: the driver has already checked the operands and picked the ID of the result, which is always a
+// new [VR,STAR] matrix
 
+int GroupWorker::get_transpose()
+{
+	ArrayID IDs[2];				// Input, output
 
-	return 0;
-}
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+
+	std::clock_t start = std::clock();
 
-int GroupWorker::get_transpose() {
+	DistMatrix_ptr A = get_matrix(IDs[0]);
+	DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(A->Width(), A->Height(), *grid);
+	El::Transpose(*A, *C);
 
+	matrices.insert(std::make_pair(IDs[1], C));
+	log->info("{} Transposed matrix {} into matrix {} in {}ms", client_preamble(), IDs[0], IDs[1],
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
 
+	get_matrix_layout();
 
 	return 0;
 }
 
 int GroupWorker::matrix_multiply()
 {
+	ArrayID IDs[3];				// Inputs, output
+
+	MPI_Bcast(IDs, 3, MPI_UNSIGNED_SHORT, 0, group);
 
+	std::clock_t start = std::clock();
 
+	DistMatrix_ptr A = get_matrix(IDs[0]);
+	DistMatrix_ptr B = get_matrix(IDs[1]);
+	DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(A->Height(), B->Width(), *grid);
+	El::Zero(*C);
+	El::Gemm(El::NORMAL, El::NORMAL, 1.0, *A, *B, 0.0, *C);
+
+	matrices.insert(std::make_pair(IDs[2], C));
+	log->info("{} Multiplied matrices {} and {} into matrix {} in {}ms", client_preamble(), IDs[0], IDs[1], IDs[2],
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+	get_matrix_layout();
 
 	return 0;
 }
 
 int GroupWorker::get_matrix_rows()
 {
+	ArrayID IDs[2];				// Input, output
+	uint64_t num_rows;
+
+	MPI_Bcast(IDs, 2, MPI_UNSIGNED_SHORT, 0, group);
+	MPI_Bcast(&num_rows, 1, MPI_UNSIGNED_LONG, 0, group);
+	vector<uint64_t> rows(num_rows);
+	MPI_Bcast(rows.data(), (int) num_rows, MPI_UNSIGNED_LONG, 0, group);
+
+	std::clock_t start = std::clock();
 
+	DistMatrix_ptr A = get_matrix(IDs[0]);
+	vector<El::Int> row_indices(rows.begin(), rows.end());
+	vector<El::Int> col_indices(A->Width());
+	for (El::Int j = 0; j < A->Width(); j++) col_indices[j] = j;
 
+	DistMatrix_ptr C = std::make_shared<El::DistMatrix<double, El::VR, El::STAR>>(*grid);
+	El::GetSubmatrix(*A, row_indices, col_indices, *C);
+
+	matrices.insert(std::make_pair(IDs[1], C));
+	log->info("{} Extracted {} rows of matrix {} into matrix {} in {}ms", client_preamble(), num_rows, IDs[0], IDs[1],
+			1000.0*((double) (std::clock() - start))/((double) CLOCKS_PER_SEC));
+
+	get_matrix_layout();
 
 	return 0;
 }
 
 void GroupWorker::deserialize_parameters(Parameters & p, Message & msg)
 {
-	string name = "";
 	datatype dt = NONE;
 	uint32_t data_length;
 	while (!msg.eom()) {
 		dt = (datatype) msg.get_datatype();
 		if (dt == PARAMETER) {
 //			msg.read_Parameter();
-			name = msg.read_string();
+			// The name, and the value of string and (where possible) array parameters, are views of the message
+			ParameterName name(msg.read_string_span());
 			dt = (datatype) msg.preview_datatype();
 
 			switch (dt) {
@@ -692,12 +2138,78 @@ void GroupWorker::deserialize_parameters(Parameters & p, Message & msg)
 				p.add_double(name, msg.read_double());
 				break;
 			case STRING:
-				p.add_string(name, msg.read_string());
+				p.add_string_view(name, msg.read_string_span());
+				break;
+			case INT16_ARRAY: {
+				vector<int16_t> storage;
+				ArraySpan<int16_t> value = msg.read_int16_array_span(storage);
+				if (storage.empty()) p.add_int16_array_view(name, value);
+				else p.add_int16_array(name, value);
+				break;
+			}
+			case INT32_ARRAY: {
+				vector<int32_t> storage;
+				ArraySpan<int32_t> value = msg.read_int32_array_span(storage);
+				if (storage.empty()) p.add_int32_array_view(name, value);
+				else p.add_int32_array(name, value);
+				break;
+			}
+			case INT64_ARRAY: {
+				vector<int64_t> storage;
+				ArraySpan<int64_t> value = msg.read_int64_array_span(storage);
+				if (storage.empty()) p.add_int64_array_view(name, value);
+				else p.add_int64_array(name, value);
+				break;
+			}
+			case UINT16_ARRAY: {
+				vector<uint16_t> storage;
+				ArraySpan<uint16_t> value = msg.read_uint16_array_span(storage);
+				if (storage.empty()) p.add_uint16_array_view(name, value);
+				else p.add_uint16_array(name, value);
+				break;
+			}
+			case UINT32_ARRAY: {
+				vector<uint32_t> storage;
+				ArraySpan<uint32_t> value = msg.read_uint32_array_span(storage);
+				if (storage.empty()) p.add_uint32_array_view(name, value);
+				else p.add_uint32_array(name, value);
+				break;
+			}
+			case UINT64_ARRAY: {
+				vector<uint64_t> storage;
+				ArraySpan<uint64_t> value = msg.read_uint64_array_span(storage);
+				if (storage.empty()) p.add_uint64_array_view(name, value);
+				else p.add_uint64_array(name, value);
+				break;
+			}
+			case FLOAT_ARRAY: {
+				vector<float> storage;
+				ArraySpan<float> value = msg.read_float_array_span(storage);
+				if (storage.empty()) p.add_float_array_view(name, value);
+				else p.add_float_array(name, value);
+				break;
+			}
+			case DOUBLE_ARRAY: {
+				vector<double> storage;
+				ArraySpan<double> value = msg.read_double_array_span(storage);
+				if (storage.empty()) p.add_double_array_view(name, value);
+				else p.add_double_array(name, value);
+				break;
+			}
+			case STRING_ARRAY:
+				p.add_string_array(name, msg.read_string_array());
+				break;
+			case LOCAL_MATRIX:
+				p.add_local_matrix(name, msg.read_local_matrix());
 				break;
-			case ARRAY_ID:
-				p.add_distmatrix(name, matrices[msg.read_ArrayID()]);
+			case ARRAY_ID: {
+				ArrayID matrixID = msg.read_ArrayID();
+				DistMatrix_ptr matrix = get_matrix(matrixID);
+				if (matrix != nullptr) p.add_distmatrix(name, matrix);
+				else log->info("Task parameter refers to unknown array {}", matrixID);
 				break;
 			}
+			}
 		}
 	}
 }
@@ -751,6 +2263,36 @@ void GroupWorker::serialize_parameters(Parameters & p, Message & msg)
 		case STRING:
 			msg.write_string(p.get_string(name));
 			break;
+		case INT16_ARRAY:
+			msg.write_int16_array(p.get_int16_array(name));
+			break;
+		case INT32_ARRAY:
+			msg.write_int32_array(p.get_int32_array(name));
+			break;
+		case INT64_ARRAY:
+			msg.write_int64_array(p.get_int64_array(name));
+			break;
+		case UINT16_ARRAY:
+			msg.write_uint16_array(p.get_uint16_array(name));
+			break;
+		case UINT32_ARRAY:
+			msg.write_uint32_array(p.get_uint32_array(name));
+			break;
+		case UINT64_ARRAY:
+			msg.write_uint64_array(p.get_uint64_array(name));
+			break;
+		case FLOAT_ARRAY:
+			msg.write_float_array(p.get_float_array(name));
+			break;
+		case DOUBLE_ARRAY:
+			msg.write_double_array(p.get_double_array(name));
+			break;
+		case STRING_ARRAY:
+			msg.write_string_array(p.get_string_array(name));
+			break;
+		case LOCAL_MATRIX:
+			msg.write_local_matrix(*p.get_local_matrix(name));
+			break;
 		case ARRAY_ID:
 			msg.write_ArrayID(p.get_matrix_info(name)->ID);
 			break;
@@ -33,6 +33,7 @@ public:
 	int start();
 
 	Grid_ptr grid;
+	Grid_ptr previous_grid;			// Grid of the previous group, kept until its matrices have been moved to the new grid
 
 	uint32_t current_grid;
 	vector<Grid_ptr> grids;
@@ -48,9 +49,12 @@ public:
 
 	int new_matrix();
 	int get_matrix_layout();
+	int create_view();
+	int evaluate_expression();
+	int get_matrix_stats();
+	int generate_matrix();
 
 	int receive_new_matrix();
-	int get_matrix_dimensions();
 	int get_transpose();
 	int matrix_multiply();
 
@@ -60,11 +64,17 @@ public:
 
 	void print_data(ArrayID ID);
 
+	DistMatrix_ptr get_matrix(ArrayID ID);
+
 	void serialize_parameters(Parameters & output_parameters, Message & msg);
 	void deserialize_parameters(Parameters & input_parameters, Message & msg);
 
+	void set_group(GroupID _groupID, bool _primary_group_worker);
 	void set_group_comm(MPI_Comm & world, MPI_Group & temp_group);
 	void set_group_peers_comm(MPI_Comm & world, MPI_Group & temp_group);
+	void cache_group_comms(const vector<WorkerID> & peers);
+	void reuse_group_comms(const vector<WorkerID> & peers);
+	void redistribute_matrices(MPI_Comm & handover, bool previous_member, bool member);
 
 	void set_value(ArrayID ID, uint64_t row, uint64_t col, float value);
 	void set_value(ArrayID ID, uint64_t row, uint64_t col, double value);
@@ -72,6 +82,11 @@ public:
 	void get_value(ArrayID ID, uint64_t row, uint64_t col, float & value);
 	void get_value(ArrayID ID, uint64_t row, uint64_t col, double & value);
 
+	bool check_block(ArrayID ID, const DoubleArrayBlock_ptr & block);
+	bool set_block(ArrayID ID, const DoubleArrayBlock_ptr & block);
+	bool get_block(ArrayID ID, const DoubleArrayBlock_ptr & block);
+	double * get_block_target(ArrayID ID, const DoubleArrayBlock_ptr & block);
+
 	int load_library();
 	void run_task();
 
@@ -80,6 +95,16 @@ private:
 	MPI_Comm group;
 	MPI_Comm group_peers;
 
+	// Communicators and grid of earlier groups, keyed by their (sorted) workers; matches the driver's cache
+	struct GroupComms {
+		MPI_Comm group;
+		MPI_Comm group_peers;
+		Grid_ptr grid;
+	};
+
+	map<vector<WorkerID>, GroupComms> cached_group_comms;
+	bool group_comms_cached;
+
 	GroupID groupID;
 	ArrayID current_matrixID;
 	SessionID next_sessionID;
@@ -94,10 +119,32 @@ private:
 	map<SessionID, WorkerSession_ptr> sessions;
 	map<ArrayID, DistMatrix_ptr> matrices;
 
+	// Views that have not been used yet, see create_view
+	struct MatrixView {
+		ArrayID parentID;
+		uint64_t rows[3];			// Start, end (exclusive), stride
+		uint64_t cols[3];
+	};
+
+	map<ArrayID, MatrixView> views;
+	std::mutex view_mutex;
+
+	// Body of the RUN_TASK message currently being run, and its output parameters if the driver does not run the task
+	// itself; reused for every task
+	Message task_msg;
+	Message output_msg;
+
 	bool connection_open;
 
 	vector<std::thread> threads;
 
+	ArrayID register_file_matrix(uint64_t dims[2]);
+	bool finish_file_matrix(const ArrayID matrixID, DistMatrix_ptr M, int success);
+	DistMatrix_ptr materialize_view(const MatrixView & view);
+	int read_matrix_file(MPI_File & file, const MatrixFileHeader & header, const string & file_name);
+	bool transfer_matrix_rows(MPI_File & file, DistMatrix_ptr M, const MPI_Offset data_offset, const bool write);
+	void place_rows(DistMatrix_ptr M, const vector<double> & rows, const uint64_t first_row, const uint64_t num_rows);
+
 //	int load_library();
 
 
@@ -128,6 +175,7 @@ private:
 	int process_input_parameters(Parameters & input_parameters);
 	int process_output_parameters(Parameters & output_parameters);
 	void read_matrix_parameters(Parameters & output_parameters);
+	void send_task_output(Parameters & output_parameters);
 
 	// -------------------------------------   Client Management   -----------------------------------
 
@@ -154,7 +202,13 @@ private:
 
 	// -----------------------------------------   File I/O   ----------------------------------------
 
-	int read_HDF5();
+	int load_matrix_file();
+	int save_matrix();
+	int save_snapshot();
+	int load_snapshot();
+	int read_HDF5(const string & file_name, const string & dataset_name);
+	int read_raw_file(const string & file_name, const uint64_t num_cols);
+	int read_text_file(const string & file_name);
 };
 
 }
@@ -15,7 +15,7 @@ using std::stringstream;
 class Message
 {
 public:
-	enum { header_length = 10 };
+	enum { header_length = 10, initial_body_length = 65536 };
 
 	uint32_t max_body_length;
 
@@ -43,12 +43,17 @@ public:
 	bool data_copied;
 	bool reverse_floats;
 	bool signed_ints_only;
+	bool little_endian;
+	bool row_layout;			// ArrayInfo carries the worker of every row instead of one per partition
 
-	Message() : Message(100000000) { }
+	SharedMemoryRegion_ptr shared_memory;
+
+	Message() : Message(initial_body_length) { }
 
 	Message(uint32_t _max_body_length) : cc(WAIT), clientID(0), sessionID(0), body_length(0), cl(C), read_pos(header_length), current_datatype(NONE),
 				current_datatype_count(0), current_datatype_count_max(0), max_body_length(_max_body_length), current_datatype_count_pos(header_length+1),
-				write_pos(header_length), data_copied(false), reverse_floats(false), signed_ints_only(false) {
+				write_pos(header_length), data_copied(false), reverse_floats(false), signed_ints_only(false),
+				little_endian(false), row_layout(false) {
 
 		data = new char[header_length + max_body_length]();
 
@@ -57,6 +62,30 @@ public:
 
 	~Message() { delete [] data; }
 
+	// Grows the buffer so that it can hold a body of the given length, keeping its current contents. Any array block
+	// pointing into the old buffer is invalidated.
+	void reserve(const uint32_t _body_length)
+	{
+		if (_body_length <= max_body_length) return;
+
+		uint64_t new_max_body_length = std::max((uint64_t) _body_length, 2*((uint64_t) max_body_length));
+		new_max_body_length = std::min(new_max_body_length, (uint64_t) UINT32_MAX - header_length);
+
+		char * new_data = new char[header_length + new_max_body_length];
+		// body_length may already be that of a message that is about to be read into the buffer
+		memcpy(new_data, data, std::min(std::max((uint32_t) write_pos, header_length + body_length), header_length + max_body_length));
+		delete [] data;
+
+		data = new_data;
+		max_body_length = (uint32_t) new_max_body_length;
+	}
+
+	void make_room(const uint64_t num_bytes)
+	{
+		if (write_pos + num_bytes > header_length + max_body_length)
+			reserve((uint32_t) (write_pos - header_length + num_bytes));
+	}
+
 	bool is_big_endian()
 	{
 	    union {
@@ -91,6 +120,7 @@ public:
 
 	void copy_body(const char * _body, const uint32_t _body_length)
 	{
+		reserve(_body_length);
 		memcpy(data + header_length, _body, _body_length);
 
 		data_copied = true;
@@ -100,6 +130,7 @@ public:
 
 	void copy_data(const char * _data, const uint32_t _data_length)
 	{
+		reserve(_data_length - header_length);
 		for (uint32_t i = 0; i < _data_length; i++) data[i] = _data[i];
 
 		data_copied = true;
@@ -177,32 +208,42 @@ public:
 		return (read_pos >= body_length + header_length);
 	}
 
+	// Whether count elements of the given size are left in the body, as far as it is held in the buffer
+	const bool has_remaining(const uint64_t count, const uint64_t element_size) const {
+		uint64_t end = header_length + std::min(body_length, max_body_length);
+
+		return read_pos <= end && count <= (end - read_pos)/element_size;
+	}
+
 	float reverse_float(float * x)
 	{
-		char * x_char = (char *) x;
-		char temp;
-		temp = x_char[0]; x_char[0] = x_char[3]; x_char[3] = temp;
-		temp = x_char[1]; x_char[1] = x_char[2]; x_char[2] = temp;
-		x = (float *) x_char;
+		reverse_bytes_scalar((char *) x, 1, 4);
 
 		return *x;
 	}
 
 	double reverse_double(double * x)
 	{
-		char * x_char = (char *) x;
-		char temp;
-		temp = x_char[0]; x_char[0] = x_char[7]; x_char[7] = temp;
-		temp = x_char[1]; x_char[1] = x_char[6]; x_char[6] = temp;
-		temp = x_char[2]; x_char[2] = x_char[5]; x_char[5] = temp;
-		temp = x_char[3]; x_char[3] = x_char[4]; x_char[4] = temp;
-		x = (double *) x_char;
+		reverse_bytes_scalar((char *) x, 1, 8);
 
 		return *x;
 	}
 
+	// Integers are big-endian on the wire unless little-endian was negotiated at the handshake, in which case these are
+	// no-ops on x86. Each conversion is its own inverse, so the same function is used for writing and reading.
+	uint16_t wire_order16(const uint16_t x) const { return little_endian ? htole16(x) : htobe16(x); }
+	uint32_t wire_order32(const uint32_t x) const { return little_endian ? htole32(x) : htobe32(x); }
+	uint64_t wire_order64(const uint64_t x) const { return little_endian ? htole64(x) : htobe64(x); }
+
+	// Converts n 64-bit integers in place between wire and host order
+	void convert_uint64_array(char * x, const size_t n)
+	{
+		if (big_endian == little_endian) reverse_bytes_64(x, n);
+	}
+
 	void put_datatype(const datatype dt)
 	{
+		make_room(1);
 		memcpy(data + write_pos++, &dt, 1);
 	}
 
@@ -248,11 +289,11 @@ public:
 	void put_ClientID(const ClientID & x)
 	{
 		if (signed_ints_only) {
-			int16_t temp = htobe16((int16_t) x);
+			int16_t temp = wire_order16((int16_t) x);
 			memcpy(data, &temp, 2);
 		}
 		else {
-			uint16_t temp = htobe16(x);
+			uint16_t temp = wire_order16(x);
 			memcpy(data, &temp, 2);
 		}
 	}
@@ -260,11 +301,11 @@ public:
 	void put_SessionID(const SessionID & x)
 	{
 		if (signed_ints_only) {
-			int16_t temp = htobe16((int16_t) x);
+			int16_t temp = wire_order16((int16_t) x);
 			memcpy(data + 2, &temp, 2);
 		}
 		else {
-			uint16_t temp = htobe16(x);
+			uint16_t temp = wire_order16(x);
 			memcpy(data + 2, &temp, 2);
 		}
 	}
@@ -283,71 +324,80 @@ public:
 	{
 		body_length = write_pos - header_length;
 		if (signed_ints_only) {
-			int32_t temp = htobe32((int32_t) body_length);
+			int32_t temp = wire_order32((int32_t) body_length);
 			memcpy(data + 6, &temp, 4);
 		}
 		else {
-			uint32_t temp = htobe32(body_length);
+			uint32_t temp = wire_order32(body_length);
 			memcpy(data + 6, &temp, 4);
 		}
 	}
 
 	void put_char(const char & x)
 	{
+		make_room(1);
 		memcpy(data + write_pos, &x, 1);
 		write_pos += 1;
 	}
 
 	void put_int8(const int8_t & x)
 	{
+		make_room(1);
 		memcpy(data + write_pos, &x, 1);
 		write_pos += 1;
 	}
 
 	void put_int16(const int16_t & x)
 	{
-		int16_t temp = htobe16(x);
+		int16_t temp = wire_order16(x);
+		make_room(2);
 		memcpy(data + write_pos, &temp, 2);
 		write_pos += 2;
 	}
 
 	void put_int32(const int32_t & x)
 	{
-		int32_t temp = htobe32(x);
+		int32_t temp = wire_order32(x);
+		make_room(4);
 		memcpy(data + write_pos, &temp, 4);
 		write_pos += 4;
 	}
 
 	void put_int64(const int64_t & x)
 	{
-		int64_t temp = htobe64(x);
+		int64_t temp = wire_order64(x);
+		make_room(8);
 		memcpy(data + write_pos, &temp, 8);
 		write_pos += 8;
 	}
 
 	void put_uint8(const uint8_t & x)
 	{
+		make_room(1);
 		memcpy(data + write_pos, &x, 1);
 		write_pos += 1;
 	}
 
 	void put_uint16(const uint16_t & x)
 	{
-		uint16_t temp = htobe16(x);
+		uint16_t temp = wire_order16(x);
+		make_room(2);
 		memcpy(data + write_pos, &temp, 2);
 		write_pos += 2;
 	}
 
 	void put_uint32(const uint32_t & x)
 	{
-		uint32_t temp = htobe32(x);
+		uint32_t temp = wire_order32(x);
+		make_room(4);
 		memcpy(data + write_pos, &temp, 4);
 		write_pos += 4;
 	}
 
 	void put_uint64(const uint64_t & x)
 	{
-		uint64_t temp = htobe64(x);
+		uint64_t temp = wire_order64(x);
+		make_room(8);
 		memcpy(data + write_pos, &temp, 8);
 		write_pos += 8;
 	}
@@ -356,6 +406,7 @@ public:
 	{
 		float temp = x;
 		if (reverse_floats) reverse_float(&temp);
+		make_room(4);
 		memcpy(data + write_pos, &temp, 4);
 		write_pos += 4;
 	}
@@ -364,6 +415,7 @@ public:
 	{
 		double temp = x;
 		if (reverse_floats) reverse_double(&temp);
+		make_room(8);
 		memcpy(data + write_pos, &temp, 8);
 		write_pos += 8;
 	}
@@ -373,10 +425,99 @@ public:
 		uint16_t string_length = (uint16_t) x.length();
 		signed_ints_only ? put_int16((int16_t) string_length) : put_uint16(string_length);
 		auto cdata = x.c_str();
+		make_room(string_length);
 		memcpy(data + write_pos, cdata, string_length);
 		write_pos += (uint32_t) string_length;
 	}
 
+	// Typed arrays have one datatype and a 32-bit length for the whole array rather than a datatype per element
+
+	void put_array_length(const uint32_t & n)
+	{
+		signed_ints_only ? put_int32((int32_t) n) : put_uint32(n);
+	}
+
+	template <typename T>
+	void put_array(const ArraySpan<T> & x, const bool reverse)
+	{
+		uint32_t n = (uint32_t) x.size();
+		put_array_length(n);
+		make_room(sizeof(T)*n);
+		memcpy(data + write_pos, x.data(), sizeof(T)*n);
+		if (reverse) reverse_bytes(data + write_pos, n, sizeof(T));
+		write_pos += sizeof(T)*n;
+	}
+
+	void put_int16_array(const ArraySpan<int16_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_int32_array(const ArraySpan<int32_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_int64_array(const ArraySpan<int64_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_uint16_array(const ArraySpan<uint16_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_uint32_array(const ArraySpan<uint32_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_uint64_array(const ArraySpan<uint64_t> & x)
+	{
+		put_array(x, big_endian == little_endian);
+	}
+
+	void put_float_array(const ArraySpan<float> & x)
+	{
+		put_array(x, reverse_floats);
+	}
+
+	void put_double_array(const ArraySpan<double> & x)
+	{
+		put_array(x, reverse_floats);
+	}
+
+	// Local matrices are sent column by column
+	void put_local_matrix(const El::Matrix<double> & x)
+	{
+		uint64_t num_rows = (uint64_t) x.Height(), num_cols = (uint64_t) x.Width();
+		signed_ints_only ? put_int64((int64_t) num_rows) : put_uint64(num_rows);
+		signed_ints_only ? put_int64((int64_t) num_cols) : put_uint64(num_cols);
+		make_room(8*num_rows*num_cols);
+		char * start = data + write_pos;
+		for (uint64_t j = 0; j < num_cols; j++) {
+			memcpy(data + write_pos, x.LockedBuffer() + j*x.LDim(), 8*num_rows);
+			write_pos += 8*num_rows;
+		}
+		if (reverse_floats) reverse_bytes_64(start, num_rows*num_cols);
+	}
+
+	// Appends data written by another message with the same settings, such as the output parameters of a task that
+	// were serialized by a worker
+	void put_raw(const char * x, const uint32_t length)
+	{
+		make_room(length);
+		memcpy(data + write_pos, x, length);
+		write_pos += length;
+	}
+
+	void put_string_array(const vector<string> & x)
+	{
+		put_array_length((uint32_t) x.size());
+		for (const string & s : x) put_string(s);
+	}
+
 	void put_LibraryID(const LibraryID & x)
 	{
 		signed_ints_only ? put_int8((int8_t) x) : put_uint8(x);
@@ -420,34 +561,67 @@ public:
 		signed_ints_only ? put_int8((int8_t) x->sparse) : put_uint8(x->sparse);
 		signed_ints_only ? put_int8((int8_t) x->layout) : put_uint8(x->layout);
 		signed_ints_only ? put_int8((int8_t) x->num_partitions) : put_uint8(x->num_partitions);
-		for (auto i = 0; i < x->num_partitions; i++)
-			signed_ints_only ? put_int8((int8_t) x->worker_assignments[i]) : put_uint8(x->worker_assignments[i]);
+		if (row_layout) put_uint16_array(x->worker_assignments);
+		else {
+			for (WorkerID worker : x->get_partition_workers())
+				signed_ints_only ? put_int8((int8_t) worker) : put_uint8((uint8_t) worker);
+		}
+	}
+
+	// Start, end and skip of each dimension, written in one go and converted to wire order together
+	void put_ArrayBlock_dims(uint64_t * const dims[3], const uint64_t ndims)
+	{
+		make_room(24*ndims);
+		char * start = data + write_pos;
+		for (uint8_t i = 0; i < 3; i++) {
+			memcpy(data + write_pos, dims[i], 8*ndims);
+			write_pos += 8*ndims;
+		}
+		convert_uint64_array(start, 3*ndims);
+	}
+
+	// Call once the data of a block added with put_FloatArrayBlock has been filled in
+	void finish_FloatArrayBlock(const FloatArrayBlock_ptr & x)
+	{
+		if (reverse_floats) reverse_bytes_32(x->start, x->size);
+	}
+
+	// Call once the data of a block added with put_DoubleArrayBlock has been filled in
+	void finish_DoubleArrayBlock(const DoubleArrayBlock_ptr & x)
+	{
+		if (reverse_floats) reverse_bytes_64(x->start, x->size);
 	}
 
 	void put_FloatArrayBlock(const FloatArrayBlock_ptr & x)
 	{
-		uint8_t ndims = x->ndims;
 		signed_ints_only ? put_int8((int8_t) x->ndims) : put_uint8(x->ndims);
 		signed_ints_only ? put_int64((int64_t) x->size) : put_uint64(x->size);
-		for (uint8_t i = 0; i < 3; i++)
-			for (uint8_t j = 0; j < ndims; j++)
-				signed_ints_only ? put_int64((int64_t) x->dims[i][j]) : put_uint64(x->dims[i][j]);
+		put_ArrayBlock_dims(x->dims, x->ndims);
+		make_room(4*x->size);
 		x->start = data + write_pos;
 		write_pos += 4*x->size;
 	}
 
 	void put_DoubleArrayBlock(const DoubleArrayBlock_ptr & x)
 	{
-		uint8_t ndims = x->ndims;
 		signed_ints_only ? put_int8((int8_t) x->ndims) : put_uint8(x->ndims);
 		signed_ints_only ? put_int64((int64_t) x->size) : put_uint64(x->size);
-		for (uint8_t i = 0; i < 3; i++)
-			for (uint8_t j = 0; j < ndims; j++)
-				signed_ints_only ? put_int64((int64_t) x->dims[i][j]) : put_uint64(x->dims[i][j]);
+		put_ArrayBlock_dims(x->dims, x->ndims);
+		make_room(8*x->size);
 		x->start = data + write_pos;
 		write_pos += 8*x->size;
 	}
 
+	// The block's data already lives in the shared memory region, so only its offset is sent
+	void put_SharedDoubleArrayBlock(const DoubleArrayBlock_ptr & x)
+	{
+		signed_ints_only ? put_int8((int8_t) x->ndims) : put_uint8(x->ndims);
+		signed_ints_only ? put_int64((int64_t) x->size) : put_uint64(x->size);
+		put_ArrayBlock_dims(x->dims, x->ndims);
+		uint64_t offset = shared_memory->offset_of(x->start);
+		signed_ints_only ? put_int64((int64_t) offset) : put_uint64(offset);
+	}
+
 	// ========================================================================================================================================================
 
 
@@ -567,6 +741,76 @@ public:
 		put_datatype(PARAMETER);
 	}
 
+	void write_int16_array(const ArraySpan<int16_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(INT16_ARRAY);
+		put_int16_array(x);
+	}
+
+	void write_int32_array(const ArraySpan<int32_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(INT32_ARRAY);
+		put_int32_array(x);
+	}
+
+	void write_int64_array(const ArraySpan<int64_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(INT64_ARRAY);
+		put_int64_array(x);
+	}
+
+	void write_uint16_array(const ArraySpan<uint16_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype((signed_ints_only ? INT16_ARRAY : UINT16_ARRAY));
+		put_uint16_array(x);
+	}
+
+	void write_uint32_array(const ArraySpan<uint32_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype((signed_ints_only ? INT32_ARRAY : UINT32_ARRAY));
+		put_uint32_array(x);
+	}
+
+	void write_uint64_array(const ArraySpan<uint64_t> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype((signed_ints_only ? INT64_ARRAY : UINT64_ARRAY));
+		put_uint64_array(x);
+	}
+
+	void write_float_array(const ArraySpan<float> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(FLOAT_ARRAY);
+		put_float_array(x);
+	}
+
+	void write_double_array(const ArraySpan<double> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(DOUBLE_ARRAY);
+		put_double_array(x);
+	}
+
+	void write_local_matrix(const El::Matrix<double> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(LOCAL_MATRIX);
+		put_local_matrix(x);
+	}
+
+	void write_string_array(const vector<string> & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(STRING_ARRAY);
+		put_string_array(x);
+	}
+
 	void write_LibraryID(const LibraryID & x, bool is_parameter = false)
 	{
 		if (is_parameter) put_datatype(PARAMETER);
@@ -623,6 +867,13 @@ public:
 		put_DoubleArrayBlock(x);
 	}
 
+	void write_SharedDoubleArrayBlock(const DoubleArrayBlock_ptr & x, bool is_parameter = false)
+	{
+		if (is_parameter) put_datatype(PARAMETER);
+		put_datatype(ARRAY_BLOCK_DOUBLE_SHARED);
+		put_SharedDoubleArrayBlock(x);
+	}
+
 	// ========================================================================================================================================================
 
 	const ClientID get_ClientID()
@@ -630,12 +881,12 @@ public:
 		if (signed_ints_only) {
 			int16_t x;
 			memcpy(&x, data, 2);
-			return (ClientID) be16toh(x);
+			return (ClientID) wire_order16(x);
 		}
 		else {
 			uint16_t x;
 			memcpy(&x, data, 2);
-			return (ClientID) be16toh(x);
+			return (ClientID) wire_order16(x);
 		}
 	}
 
@@ -644,12 +895,12 @@ public:
 		if (signed_ints_only) {
 			int16_t x;
 			memcpy(&x, data + 2, 2);
-			return (SessionID) be16toh(x);
+			return (SessionID) wire_order16(x);
 		}
 		else {
 			uint16_t x;
 			memcpy(&x, data + 2, 2);
-			return (SessionID) be16toh(x);
+			return (SessionID) wire_order16(x);
 		}
 	}
 
@@ -674,12 +925,12 @@ public:
 		if (signed_ints_only) {
 			int32_t x;
 			memcpy(&x, data + 6, 4);
-			return (uint32_t) be32toh(x);
+			return (uint32_t) wire_order32(x);
 		}
 		else {
 			uint32_t x;
 			memcpy(&x, data + 6, 4);
-			return be32toh(x);
+			return wire_order32(x);
 		}
 	}
 
@@ -720,7 +971,7 @@ public:
 		memcpy(&x, data + read_pos, 2);
 		read_pos += 2;
 
-		return be16toh(x);
+		return wire_order16(x);
 	}
 
 	const int32_t get_int32()
@@ -730,7 +981,7 @@ public:
 		memcpy(&x, data + read_pos, 4);
 		read_pos += 4;
 
-		return be32toh(x);
+		return wire_order32(x);
 	}
 
 	const int64_t get_int64()
@@ -740,7 +991,7 @@ public:
 		memcpy(&x, data + read_pos, 8);
 		read_pos += 8;
 
-		return be64toh(x);
+		return wire_order64(x);
 	}
 
 	const uint8_t get_uint8()
@@ -760,7 +1011,7 @@ public:
 		memcpy(&x, data + read_pos, 2);
 		read_pos += 2;
 
-		return be16toh(x);
+		return wire_order16(x);
 	}
 
 	const uint32_t get_uint32()
@@ -770,7 +1021,7 @@ public:
 		memcpy(&x, data + read_pos, 4);
 		read_pos += 4;
 
-		return be32toh(x);
+		return wire_order32(x);
 	}
 
 	const uint64_t get_uint64()
@@ -780,7 +1031,7 @@ public:
 		memcpy(&x, data + read_pos, 8);
 		read_pos += 8;
 
-		return be64toh(x);
+		return wire_order64(x);
 	}
 
 	const float get_float()
@@ -816,6 +1067,203 @@ public:
 		return string(string_c);
 	}
 
+	// Same as get_string, but refers to the characters in the message instead of copying them
+	const ArraySpan<char> get_string_span()
+	{
+		uint16_t string_length = signed_ints_only ? (uint16_t) get_int16() : get_uint16();
+		if ((uint64_t) read_pos + string_length > header_length + body_length) {
+			std::cerr << "ERROR: String extends past end of message" << std::endl;
+			throw std::exception();
+		}
+		const char * start = data + read_pos;
+		read_pos += string_length;
+
+		return ArraySpan<char>(start, string_length);
+	}
+
+	const uint32_t get_array_length()
+	{
+		return signed_ints_only ? (uint32_t) get_int32() : get_uint32();
+	}
+
+	template <typename T>
+	void get_array(vector<T> & x, const bool reverse)
+	{
+		uint32_t n = get_array_length();
+		if ((uint64_t) read_pos + sizeof(T)*n > header_length + body_length) {
+			std::cerr << "ERROR: Array extends past end of message" << std::endl;
+			throw std::exception();
+		}
+		x.resize(n);
+		memcpy(x.data(), data + read_pos, sizeof(T)*n);
+		if (reverse) reverse_bytes((char *) x.data(), n, sizeof(T));
+		read_pos += sizeof(T)*n;
+	}
+
+	const vector<int16_t> get_int16_array()
+	{
+		vector<int16_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<int32_t> get_int32_array()
+	{
+		vector<int32_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<int64_t> get_int64_array()
+	{
+		vector<int64_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<uint16_t> get_uint16_array()
+	{
+		vector<uint16_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<uint32_t> get_uint32_array()
+	{
+		vector<uint32_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<uint64_t> get_uint64_array()
+	{
+		vector<uint64_t> x;
+		get_array(x, big_endian == little_endian);
+
+		return x;
+	}
+
+	const vector<float> get_float_array()
+	{
+		vector<float> x;
+		get_array(x, reverse_floats);
+
+		return x;
+	}
+
+	const vector<double> get_double_array()
+	{
+		vector<double> x;
+		get_array(x, reverse_floats);
+
+		return x;
+	}
+
+	// Typed array data is used in place when it needs no conversion and is suitably aligned, otherwise it is copied
+	// into storage. Either way the data must not be used after the message has been cleared or destroyed.
+	template <typename T>
+	const ArraySpan<T> get_array_span(vector<T> & storage, const bool reverse)
+	{
+		uint32_t n = get_array_length();
+		if ((uint64_t) read_pos + sizeof(T)*n > header_length + body_length) {
+			std::cerr << "ERROR: Array extends past end of message" << std::endl;
+			throw std::exception();
+		}
+		const char * start = data + read_pos;
+		read_pos += sizeof(T)*n;
+
+		if (!reverse && reinterpret_cast<uintptr_t>(start) % alignof(T) == 0)
+			return ArraySpan<T>((const T *) start, n);
+
+		storage.resize(n);
+		memcpy(storage.data(), start, sizeof(T)*n);
+		if (reverse) reverse_bytes((char *) storage.data(), n, sizeof(T));
+
+		return ArraySpan<T>(storage);
+	}
+
+	const ArraySpan<int16_t> get_int16_array_span(vector<int16_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<int32_t> get_int32_array_span(vector<int32_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<int64_t> get_int64_array_span(vector<int64_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<uint16_t> get_uint16_array_span(vector<uint16_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<uint32_t> get_uint32_array_span(vector<uint32_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<uint64_t> get_uint64_array_span(vector<uint64_t> & storage)
+	{
+		return get_array_span(storage, big_endian == little_endian);
+	}
+
+	const ArraySpan<float> get_float_array_span(vector<float> & storage)
+	{
+		return get_array_span(storage, reverse_floats);
+	}
+
+	const ArraySpan<double> get_double_array_span(vector<double> & storage)
+	{
+		return get_array_span(storage, reverse_floats);
+	}
+
+	// As with array spans, a local matrix is attached to the message data when possible
+	const LocalMatrix_ptr get_local_matrix()
+	{
+		uint64_t num_rows = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
+		uint64_t num_cols = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
+		if ((uint64_t) read_pos + 8*num_rows*num_cols > header_length + body_length) {
+			std::cerr << "ERROR: Local matrix extends past end of message" << std::endl;
+			throw std::exception();
+		}
+		const char * start = data + read_pos;
+		read_pos += 8*num_rows*num_cols;
+
+		LocalMatrix_ptr x = std::make_shared<El::Matrix<double>>();
+		if (!reverse_floats && reinterpret_cast<uintptr_t>(start) % alignof(double) == 0)
+			x->LockedAttach((El::Int) num_rows, (El::Int) num_cols, (const double *) start, (El::Int) std::max(num_rows, (uint64_t) 1));
+		else {
+			x->Resize((El::Int) num_rows, (El::Int) num_cols);
+			for (uint64_t j = 0; j < num_cols; j++)
+				memcpy(x->Buffer() + j*x->LDim(), start + 8*j*num_rows, 8*num_rows);
+			if (reverse_floats)
+				for (uint64_t j = 0; j < num_cols; j++)
+					reverse_bytes_64((char *) (x->Buffer() + j*x->LDim()), num_rows);
+		}
+
+		return x;
+	}
+
+	const vector<string> get_string_array()
+	{
+		uint32_t n = get_array_length();
+		vector<string> x;
+		x.reserve(n);
+		for (uint32_t i = 0; i < n; i++) x.push_back(get_string());
+
+		return x;
+	}
+
 	const LibraryID get_LibraryID()
 	{
 		return (LibraryID) (signed_ints_only ? get_int8() : get_uint8());
@@ -859,36 +1307,85 @@ public:
 
 		ArrayInfo_ptr x = std::make_shared<ArrayInfo>(ID, name, num_rows, num_cols, sparse, layout, num_partitions);
 
-		for (auto i = 0; i < num_partitions; i++)
-			x->worker_assignments[i] = (uint8_t) (signed_ints_only ? get_int8() : get_uint8());
+		if (row_layout) {
+			// Clients may leave out the row layout, which is determined by Alchemist anyway
+			vector<WorkerID> worker_assignments = get_uint16_array();
+			if (worker_assignments.size() == num_rows) x->worker_assignments = worker_assignments;
+		}
+		else {
+			vector<WorkerID> partition_workers(num_partitions);
+			for (auto i = 0; i < num_partitions; i++)
+				partition_workers[i] = (WorkerID) (uint8_t) (signed_ints_only ? get_int8() : get_uint8());
+			x->set_partition_workers(partition_workers);
+		}
 
 		return x;
 	}
 
+	// Start, end and skip of each dimension in turn, converted from wire order together; returns false if they run past
+	// the end of the message
+	bool get_ArrayBlock_dims(uint64_t * dims[3], const uint64_t ndims)
+	{
+		if (!has_remaining(3*ndims, 8)) return false;
+
+		vector<uint64_t> temp(3*ndims);
+		memcpy(temp.data(), data + read_pos, 24*ndims);
+		convert_uint64_array((char *) temp.data(), 3*ndims);
+		read_pos += 24*ndims;
+
+		for (uint8_t j = 0; j < ndims; j++)
+			for (uint8_t k = 0; k < 3; k++)
+				dims[k][j] = temp[3*j+k];
+
+		return true;
+	}
+
+	// Array blocks are read in place; the getters return nullptr if a block runs past the end of the message
+
 	const FloatArrayBlock_ptr get_FloatArrayBlock()
 	{
 		uint8_t ndims = (uint8_t) (signed_ints_only ? get_int8() : get_uint8());
 		FloatArrayBlock_ptr block = std::make_shared<ArrayBlock<float>>(ndims);
 		block->size = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
-		for (uint8_t j = 0; j < ndims; j++)
-			for (uint8_t k = 0; k < 3; k++)
-				block->dims[k][j] = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
+		if (!get_ArrayBlock_dims(block->dims, ndims) || !has_remaining(block->size, 4)) return nullptr;
 		block->start = data + read_pos;
 		read_pos += 4*block->size;
+		if (reverse_floats) reverse_bytes_32(block->start, block->size);
 
 		return block;
 	}
 
-	const DoubleArrayBlock_ptr get_DoubleArrayBlock()
+	// Reads the size and dimensions of a block but not its data, which may be placed elsewhere by the caller
+	const DoubleArrayBlock_ptr get_DoubleArrayBlock_header()
 	{
 		uint8_t ndims = (uint8_t) (signed_ints_only ? get_int8() : get_uint8());
 		DoubleArrayBlock_ptr block = std::make_shared<ArrayBlock<double>>(ndims);
 		block->size = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
-		for (uint8_t j = 0; j < ndims; j++)
-			for (uint8_t k = 0; k < 3; k++)
-				block->dims[k][j] = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
+		if (!get_ArrayBlock_dims(block->dims, ndims)) return nullptr;
+
+		return block;
+	}
+
+	const DoubleArrayBlock_ptr get_DoubleArrayBlock()
+	{
+		DoubleArrayBlock_ptr block = get_DoubleArrayBlock_header();
+		if (block == nullptr || !has_remaining(block->size, 8)) return nullptr;
 		block->start = data + read_pos;
 		read_pos += 8*block->size;
+		if (reverse_floats) reverse_bytes_64(block->start, block->size);
+
+		return block;
+	}
+
+	// Also returns nullptr if the block does not lie inside the shared memory region
+	const DoubleArrayBlock_ptr get_SharedDoubleArrayBlock()
+	{
+		DoubleArrayBlock_ptr block = get_DoubleArrayBlock_header();
+		if (block == nullptr) return nullptr;
+		uint64_t offset = (uint64_t) (signed_ints_only ? get_int64() : get_uint64());
+
+		if (shared_memory == nullptr || !shared_memory->contains(offset, 8*block->size)) return nullptr;
+		block->start = shared_memory->at(offset);
 
 		return block;
 	}
@@ -1020,11 +1517,126 @@ public:
 		return get_string();
 	}
 
+	const ArraySpan<char> read_string_span()
+	{
+		check_datatype(STRING);
+
+		return get_string_span();
+	}
+
 	void read_Parameter()
 	{
 		check_datatype(PARAMETER);
 	}
 
+	const vector<int16_t> read_int16_array()
+	{
+		check_datatype(INT16_ARRAY);
+		return get_int16_array();
+	}
+
+	const vector<int32_t> read_int32_array()
+	{
+		check_datatype(INT32_ARRAY);
+		return get_int32_array();
+	}
+
+	const vector<int64_t> read_int64_array()
+	{
+		check_datatype(INT64_ARRAY);
+		return get_int64_array();
+	}
+
+	const vector<uint16_t> read_uint16_array()
+	{
+		check_datatype((signed_ints_only ? INT16_ARRAY : UINT16_ARRAY));
+		return get_uint16_array();
+	}
+
+	const vector<uint32_t> read_uint32_array()
+	{
+		check_datatype((signed_ints_only ? INT32_ARRAY : UINT32_ARRAY));
+		return get_uint32_array();
+	}
+
+	const vector<uint64_t> read_uint64_array()
+	{
+		check_datatype((signed_ints_only ? INT64_ARRAY : UINT64_ARRAY));
+		return get_uint64_array();
+	}
+
+	const vector<float> read_float_array()
+	{
+		check_datatype(FLOAT_ARRAY);
+		return get_float_array();
+	}
+
+	const vector<double> read_double_array()
+	{
+		check_datatype(DOUBLE_ARRAY);
+		return get_double_array();
+	}
+
+	const ArraySpan<int16_t> read_int16_array_span(vector<int16_t> & storage)
+	{
+		check_datatype(INT16_ARRAY);
+		return get_int16_array_span(storage);
+	}
+
+	const ArraySpan<int32_t> read_int32_array_span(vector<int32_t> & storage)
+	{
+		check_datatype(INT32_ARRAY);
+		return get_int32_array_span(storage);
+	}
+
+	const ArraySpan<int64_t> read_int64_array_span(vector<int64_t> & storage)
+	{
+		check_datatype(INT64_ARRAY);
+		return get_int64_array_span(storage);
+	}
+
+	const ArraySpan<uint16_t> read_uint16_array_span(vector<uint16_t> & storage)
+	{
+		check_datatype((signed_ints_only ? INT16_ARRAY : UINT16_ARRAY));
+		return get_uint16_array_span(storage);
+	}
+
+	const ArraySpan<uint32_t> read_uint32_array_span(vector<uint32_t> & storage)
+	{
+		check_datatype((signed_ints_only ? INT32_ARRAY : UINT32_ARRAY));
+		return get_uint32_array_span(storage);
+	}
+
+	const ArraySpan<uint64_t> read_uint64_array_span(vector<uint64_t> & storage)
+	{
+		check_datatype((signed_ints_only ? INT64_ARRAY : UINT64_ARRAY));
+		return get_uint64_array_span(storage);
+	}
+
+	const ArraySpan<float> read_float_array_span(vector<float> & storage)
+	{
+		check_datatype(FLOAT_ARRAY);
+		return get_float_array_span(storage);
+	}
+
+	const ArraySpan<double> read_double_array_span(vector<double> & storage)
+	{
+		check_datatype(DOUBLE_ARRAY);
+		return get_double_array_span(storage);
+	}
+
+	const LocalMatrix_ptr read_local_matrix()
+	{
+		check_datatype(LOCAL_MATRIX);
+		return get_local_matrix();
+	}
+
+	const vector<string> read_string_array()
+	{
+		check_datatype(STRING_ARRAY);
+		return get_string_array();
+	}
+
 	const LibraryID read_LibraryID()
 	{
 		check_datatype(LIBRARY_ID);
@@ -1081,21 +1693,51 @@ public:
 		return get_DoubleArrayBlock();
 	}
 
+	const DoubleArrayBlock_ptr read_SharedDoubleArrayBlock()
+	{
+		check_datatype(ARRAY_BLOCK_DOUBLE_SHARED);
+
+		return get_SharedDoubleArrayBlock();
+	}
+
 	// ========================================================================================================================================================
 
-	bool compare_array_block(DoubleArrayBlock_ptr block, double * temp)
+	bool compare_array_block(DoubleArrayBlock_ptr block, double * temp, const uint64_t size)
 	{
+		if (block == nullptr || block->size != size) return false;
+
 		double local;
 		for (uint64_t i = 0; i < block->size; i++) {
 			memcpy(&local, block->start + 8*i, 8);
-			if (local != temp[i]) {
-				if (reverse_floats) reverse_double(&local);
-				if (local != temp[i]) return false;
-			}
+			if (local != temp[i]) return false;
 		}
 		return true;
 	}
 
+	// Length and first few values of a typed array
+	template <typename T>
+	const string array_to_string(const vector<T> & x)
+	{
+		stringstream ss;
+
+		ss << "Length = " << x.size() << ":";
+		for (size_t i = 0; i < x.size() && i < 10; i++) ss << " " << +x[i];
+		if (x.size() > 10) ss << " ...";
+
+		return ss.str();
+	}
+
+	const string array_to_string(const vector<string> & x)
+	{
+		stringstream ss;
+
+		ss << "Length = " << x.size() << ":";
+		for (size_t i = 0; i < x.size() && i < 10; i++) ss << " '" << x[i] << "'";
+		if (x.size() > 10) ss << " ...";
+
+		return ss.str();
+	}
+
 	const string to_string()
 	{
 		decode_header();
@@ -1114,6 +1756,10 @@ public:
 		ss << space << "---------------------------------------------------------" << std::endl;
 		ss << std::endl;
 
+		// Block data is converted in place when read, which must not happen while just printing the message
+		bool _reverse_floats = reverse_floats;
+		reverse_floats = false;
+
 		while (!eom()) {
 			dt = get_datatype();
 			dt_name = get_datatype_name(dt);
@@ -1171,12 +1817,53 @@ public:
 			case ARRAY_INFO:
 				ss << get_ArrayInfo()->to_string();
 				break;
-			case ARRAY_BLOCK_DOUBLE:
-				ss << get_DoubleArrayBlock()->to_string();
+			case ARRAY_BLOCK_DOUBLE: {
+				DoubleArrayBlock_ptr block = get_DoubleArrayBlock();
+				ss << ((block != nullptr) ? block->to_string() : string("Past end of message"));
 				break;
-			case ARRAY_BLOCK_FLOAT:
-				ss << get_FloatArrayBlock()->to_string();
+			}
+			case ARRAY_BLOCK_FLOAT: {
+				FloatArrayBlock_ptr block = get_FloatArrayBlock();
+				ss << ((block != nullptr) ? block->to_string() : string("Past end of message"));
+				break;
+			}
+			case ARRAY_BLOCK_DOUBLE_SHARED: {
+				DoubleArrayBlock_ptr block = get_SharedDoubleArrayBlock();
+				ss << ((block != nullptr) ? block->to_string() : string("Outside shared memory region"));
+				break;
+			}
+			case INT16_ARRAY:
+				ss << array_to_string(get_int16_array());
 				break;
+			case INT32_ARRAY:
+				ss << array_to_string(get_int32_array());
+				break;
+			case INT64_ARRAY:
+				ss << array_to_string(get_int64_array());
+				break;
+			case UINT16_ARRAY:
+				ss << array_to_string(get_uint16_array());
+				break;
+			case UINT32_ARRAY:
+				ss << array_to_string(get_uint32_array());
+				break;
+			case UINT64_ARRAY:
+				ss << array_to_string(get_uint64_array());
+				break;
+			case FLOAT_ARRAY:
+				ss << array_to_string(get_float_array());
+				break;
+			case DOUBLE_ARRAY:
+				ss << array_to_string(get_double_array());
+				break;
+			case STRING_ARRAY:
+				ss << array_to_string(get_string_array());
+				break;
+			case LOCAL_MATRIX: {
+				LocalMatrix_ptr x = get_local_matrix();
+				ss << x->Height() << " x " << x->Width();
+				break;
+			}
 			case LIBRARY_ID:
 				ss << (int16_t) get_LibraryID();
 				break;
@@ -1189,6 +1876,7 @@ public:
 		ss << space << "=========================================================" << std::endl;
 
 		read_pos = header_length;
+		reverse_floats = _reverse_floats;
 
 		return ss.str();
 	}
@@ -2,6 +2,7 @@
 #define ALCHEMIST__PARAMETERS_HPP
 
 #include "Message.hpp"
+#include "utility/arena.hpp"
 
 namespace alchemist {
 
@@ -10,1385 +11,856 @@ typedef std::shared_ptr<El::AbstractDistMatrix<double>> DistMatrix_ptr;
 
 using std::string;
 using std::stringstream;
-//
-//template <class T>
-//class Parameter_ {
-//public:
-//	string name;
-//	datatype dt;
-//	T value;
-//
-//	Parameter_(string _name, datatype _dt, T _value) {
-//		name = _name;
-//		dt = _dt;
-//		value = _value;
-//	}
-//};
-
-struct Parameter {
-public:
-	Parameter(string _name, datatype _dt) : name(_name), dt(_dt) { }
-
-	virtual ~Parameter() {}
-
-	datatype dt;
-
-	string get_name() const {
-		return name;
-	}
-
-	virtual string to_string() const = 0;
-protected:
-	string name;
-};
 
-struct CharParameter : Parameter {
+// Name of a parameter as passed to Parameters. Names given as strings are copied when the parameter is added, while
+// names read from a message (ParameterName(msg.read_string_span())) are referred to where they are.
+struct ParameterName {
 public:
-	CharParameter(string _name, char _value) : Parameter(_name, CHAR), value(_value) { }
-
-	~CharParameter() { }
-
-	char get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		string s = "" + value;
-		return s;
-	}
+	ParameterName(const string & name) : ptr(name.data()), length(name.length()), copy(true) { }
+	ParameterName(const char * name) : ptr(name), length(strlen(name)), copy(true) { }
+	explicit ParameterName(const ArraySpan<char> & name) : ptr(name.data()), length(name.size()), copy(false) { }
 
-protected:
-	char value;
+	const char * ptr;
+	size_t length;
+	bool copy;
 };
 
-struct SignedCharParameter : Parameter {
+// Input and output parameters of a task, kept in a flat table in the order they were added. Each entry holds the
+// parameter's name, its datatype and up to 16 bytes of value: scalars are stored in the entry itself, strings and
+// arrays as a view of either the task message or the table's arena, and shared pointers as an index into a side
+// table. Looking up a parameter is a linear scan, which is faster than a map for the handful of parameters a task
+// has. As with the map this replaces, adding a parameter with an existing name has no effect.
+//
+// Views of a message are only valid as long as the message, which for task inputs lasts until the task returns.
+struct Parameters {
 public:
-	SignedCharParameter(string _name, signed char _value) : Parameter(_name, SIGNED_CHAR), value(_value) { }
-
-	~SignedCharParameter() {}
-
-	signed char get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		string s = "" + value;
-		return s;
-	}
-
-protected:
-	signed char value;
-};
+	Parameters() : num_entries(0), num_pointers(0), current_parameter_count(0), current_distmatrix_count(0) { }
 
-struct UnsignedCharParameter : Parameter {
-public:
-	UnsignedCharParameter(string _name, unsigned char _value) : Parameter(_name, UNSIGNED_CHAR), value(_value) { }
+	Parameters(const Parameters &) = delete;
+	Parameters & operator=(const Parameters &) = delete;
 
-	~UnsignedCharParameter() {}
+	~Parameters() { }
 
-	unsigned char get_value() const {
-		return value;
-	}
+	datatype get_next_parameter()
+	{
+		if (current_parameter_count >= num_entries) return NONE;
 
-	string to_string() const {
-		string s = "" + value;
-		return s;
+		return entry(current_parameter_count++).dt;
 	}
 
-protected:
-	unsigned char value;
-};
-
-struct CharacterParameter : Parameter {
-public:
-	CharacterParameter(string _name, char _value) : Parameter(_name, CHARACTER), value(_value) { }
+	void get_next_distmatrix(string & distmatrix_name, DistMatrix_ptr & distmatrix_ptr)
+	{
+		distmatrix_name = "";
+		distmatrix_ptr = nullptr;
 
-	~CharacterParameter() {}
+		if (current_distmatrix_count >= distmatrices.size()) return;
 
-	char get_value() const {
-		return value;
+		for (uint32_t i = 0; i < num_entries; i++) {
+			const Entry & e = entry(i);
+			if (e.dt == DISTMATRIX && get_value_at<uint32_t>(e) == current_distmatrix_count) {
+				distmatrix_name = string(e.name, e.name_length);
+				distmatrix_ptr = distmatrices[current_distmatrix_count++];
+				return;
+			}
+		}
 	}
 
-	string to_string() const {
-		string s = "" + value;
-		return s;
+	// Name of the parameter last returned by get_next_parameter
+	std::string get_name() {
+		const Entry & e = entry(current_parameter_count - 1);
+		return string(e.name, e.name_length);
 	}
 
-protected:
-	char value;
-};
-
-struct WcharParameter : Parameter {
-public:
-	WcharParameter(string _name, wchar_t _value) : Parameter(_name, WCHAR), value(_value) { }
-
-	~WcharParameter() {}
-
-	wchar_t get_value() const {
-		return value;
+	uint8_t num_distmatrices() {
+		return (uint8_t) distmatrices.size();
 	}
 
-	string to_string() const {
-		string s = "" + value;
-		return s;
+	uint8_t num_matrix_infos() {
+		return (uint8_t) matrix_infos.size();
 	}
 
-protected:
-	wchar_t value;
-};
-
-struct ShortParameter : Parameter {
-public:
-	ShortParameter(string _name, short _value) : Parameter(_name, SHORT), value(_value) { }
-
-	~ShortParameter() {}
-
-	short get_value() const {
-		return value;
+	uint8_t num_void_pointers() {
+		return num_pointers;
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	int num() const {
+		return (int) num_entries;
 	}
 
-protected:
-	short value;
-};
-
-struct UnsignedShortParameter : Parameter {
-public:
-	UnsignedShortParameter(string _name, unsigned short _value) : Parameter(_name, UNSIGNED_SHORT), value(_value) { }
-
-	~UnsignedShortParameter() {}
-
-	unsigned short get_value() const {
-		return value;
+	bool contains(const ParameterName & name) const {
+		return find(name) != nullptr;
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	datatype get_datatype(const ParameterName & name) const {
+		const Entry * e = find(name);
+		return (e == nullptr) ? NONE : e->dt;
 	}
 
-protected:
-	unsigned short value;
-};
-
-struct IntParameter : Parameter {
-public:
-	IntParameter(string _name, int _value) : Parameter(_name, INT), value(_value) { }
-
-	~IntParameter() {}
-
-	int get_value() const {
-		return value;
+	void add_char(const ParameterName & name, char value) {
+		add_value(name, CHAR, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_signed_char(const ParameterName & name, signed char value) {
+		add_value(name, SIGNED_CHAR, value);
 	}
 
-protected:
-	int value;
-};
-
-struct IntegerParameter : Parameter {
-public:
-	IntegerParameter(string _name, int _value) : Parameter(_name, INTEGER), value(_value) { }
-
-	~IntegerParameter() {}
-
-	int get_value() const {
-		return value;
+	void add_unsigned_char(const ParameterName & name, unsigned char value) {
+		add_value(name, UNSIGNED_CHAR, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_character(const ParameterName & name, char value) {
+		add_value(name, CHARACTER, value);
 	}
 
-protected:
-	int value;
-};
-
-struct UnsignedParameter : Parameter {
-public:
-	UnsignedParameter(string _name, unsigned int _value) : Parameter(_name, UNSIGNED), value(_value) { }
-
-	~UnsignedParameter() {}
-
-	unsigned int get_value() const {
-		return value;
+	void add_wchar(const ParameterName & name, wchar_t value) {
+		add_value(name, WCHAR, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_short(const ParameterName & name, short value) {
+		add_value(name, SHORT, value);
 	}
 
-protected:
-	unsigned int value;
-};
-
-struct LongParameter : Parameter {
-public:
-	LongParameter(string _name, long _value) : Parameter(_name, LONG), value(_value) { }
-
-	~LongParameter() {}
-
-	long get_value() const {
-		return value;
+	void add_unsigned_short(const ParameterName & name, unsigned short value) {
+		add_value(name, UNSIGNED_SHORT, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_int(const ParameterName & name, int value) {
+		add_value(name, INT, value);
 	}
 
-protected:
-	long value;
-};
-
-struct UnsignedLongParameter : Parameter {
-public:
-	UnsignedLongParameter(string _name, unsigned long _value) : Parameter(_name, UNSIGNED_LONG), value(_value) { }
-
-	~UnsignedLongParameter() {}
-
-	unsigned long get_value() const {
-		return value;
+	void add_unsigned(const ParameterName & name, unsigned int value) {
+		add_value(name, UNSIGNED, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_long(const ParameterName & name, long value) {
+		add_value(name, LONG, value);
 	}
 
-protected:
-	unsigned long value;
-};
-
-struct LongLongIntParameter : Parameter {
-public:
-	LongLongIntParameter(string _name, long long int _value) : Parameter(_name, LONG_LONG_INT), value(_value) { }
-
-	~LongLongIntParameter() {}
-
-	long long int get_value() const {
-		return value;
+	void add_unsigned_long(const ParameterName & name, unsigned long value) {
+		add_value(name, UNSIGNED_LONG, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_long_long_int(const ParameterName & name, long long int value) {
+		add_value(name, LONG_LONG_INT, value);
 	}
 
-protected:
-	long long int value;
-};
-
-struct LongLongParameter : Parameter {
-public:
-	LongLongParameter(string _name, long long _value) : Parameter(_name, LONG_LONG), value(_value) { }
-
-	~LongLongParameter() {}
-
-	long long get_value() const {
-		return value;
+	void add_long_long(const ParameterName & name, long long int value) {
+		add_value(name, LONG_LONG, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_unsigned_long_long(const ParameterName & name, unsigned long long int value) {
+		add_value(name, UNSIGNED_LONG_LONG, value);
 	}
 
-protected:
-	long long value;
-};
-
-struct UnsignedLongLongParameter : Parameter {
-public:
-	UnsignedLongLongParameter(string _name, unsigned long long _value) : Parameter(_name, UNSIGNED_LONG_LONG), value(_value) { }
-
-	~UnsignedLongLongParameter() {}
-
-	unsigned long long get_value() const {
-		return value;
+	void add_float(const ParameterName & name, float value) {
+		add_value(name, FLOAT, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_double(const ParameterName & name, double value) {
+		add_value(name, DOUBLE, value);
 	}
 
-protected:
-	unsigned long long value;
-};
-
-struct FloatParameter : Parameter {
-public:
-	FloatParameter(string _name, float _value) : Parameter(_name, FLOAT), value(_value) { }
-
-	~FloatParameter() {}
-
-	float get_value() const {
-		return value;
+	void add_long_double(const ParameterName & name, long double value) {
+		add_value(name, LONG_DOUBLE, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_byte(const ParameterName & name, uint8_t value) {
+		add_value(name, BYTE, value);
 	}
 
-protected:
-	float value;
-};
-
-struct DoubleParameter : Parameter {
-public:
-	DoubleParameter(string _name, double _value) : Parameter(_name, DOUBLE), value(_value) { }
-
-	~DoubleParameter() {}
-
-	double get_value() const {
-		return value;
+	void add_bool(const ParameterName & name, bool value) {
+		add_value(name, BOOL, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_integer(const ParameterName & name, int value) {
+		add_value(name, INTEGER, value);
 	}
 
-protected:
-	double value;
-};
-
-struct LongDoubleParameter : Parameter {
-public:
-	LongDoubleParameter(string _name, long double _value) : Parameter(_name, LONG_DOUBLE), value(_value) { }
-
-	~LongDoubleParameter() {}
-
-	long double get_value() const {
-		return value;
+	void add_real(const ParameterName & name, double value) {
+		add_value(name, REAL, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_logical(const ParameterName & name, bool value) {
+		add_value(name, LOGICAL, value);
 	}
 
-protected:
-	long double value;
-};
-
-struct ByteParameter : Parameter {
-public:
-	ByteParameter(string _name, uint8_t _value) : Parameter(_name, BYTE), value(_value) { }
-
-	~ByteParameter() {}
-
-	uint8_t get_value() const {
-		return value;
+	void add_complex(const ParameterName & name, std::complex<double> value) {
+		add_value(name, COMPLEX, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_double_precision(const ParameterName & name, double value) {
+		add_value(name, DOUBLE_PRECISION, value);
 	}
 
-protected:
-	uint8_t value;
-};
-
-struct BoolParameter : Parameter {
-public:
-	BoolParameter(string _name, bool _value) : Parameter(_name, BOOL), value(_value) { }
-
-	~BoolParameter() {}
-
-	bool get_value() const {
-		return value;
+	void add_real4(const ParameterName & name, float value) {
+		add_value(name, REAL4, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_complex8(const ParameterName & name, std::complex<float> value) {
+		add_value(name, COMPLEX8, value);
 	}
 
-protected:
-	bool value;
-};
-
-struct RealParameter : Parameter {
-public:
-	RealParameter(string _name, double _value) : Parameter(_name, REAL), value(_value) { }
-
-	~RealParameter() {}
-
-	double get_value() const {
-		return value;
+	void add_real8(const ParameterName & name, double value) {
+		add_value(name, REAL8, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_complex16(const ParameterName & name, std::complex<double> value) {
+		add_value(name, COMPLEX16, value);
 	}
 
-protected:
-	double value;
-};
-
-struct LogicalParameter : Parameter {
-public:
-	LogicalParameter(string _name, bool _value) : Parameter(_name, LOGICAL), value(_value) { }
-
-	~LogicalParameter() {}
-
-	bool get_value() const {
-		return value;
+	void add_integer1(const ParameterName & name, int8_t value) {
+		add_value(name, INTEGER1, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_integer2(const ParameterName & name, int16_t value) {
+		add_value(name, INTEGER2, value);
 	}
 
-protected:
-	bool value;
-};
-
-struct ComplexParameter : Parameter {
-public:
-	ComplexParameter(string _name, std::complex<double> _value) : Parameter(_name, COMPLEX), value(0) { value = _value; }
-
-	~ComplexParameter() {}
-
-	std::complex<double> get_value() const {
-		return value;
+	void add_integer4(const ParameterName & name, int32_t value) {
+		add_value(name, INTEGER4, value);
 	}
 
-	string to_string() const {
-		stringstream ss;
-
-		ss << value;
-
-		return ss.str();
+	void add_integer8(const ParameterName & name, int64_t value) {
+		add_value(name, INTEGER8, value);
 	}
 
-protected:
-	std::complex<double> value;
-};
-
-struct DoublePrecisionParameter : Parameter {
-public:
-	DoublePrecisionParameter(string _name, double _value) : Parameter(_name, DOUBLE_PRECISION), value(_value) { }
-
-	~DoublePrecisionParameter() {}
-
-	double get_value() const {
-		return value;
+	void add_int8(const ParameterName & name, int8_t value) {
+		add_value(name, INT8, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_int16(const ParameterName & name, int16_t value) {
+		add_value(name, INT16, value);
 	}
 
-protected:
-	double value;
-};
-
-struct Real4Parameter : Parameter {
-public:
-	Real4Parameter(string _name, float _value) : Parameter(_name, REAL4), value(_value) { }
-
-	~Real4Parameter() {}
-
-	float get_value() const {
-		return value;
+	void add_int32(const ParameterName & name, int32_t value) {
+		add_value(name, INT32, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_int64(const ParameterName & name, int64_t value) {
+		add_value(name, INT64, value);
 	}
 
-protected:
-	float value;
-};
-
-struct Real8Parameter : Parameter {
-public:
-	Real8Parameter(string _name, double _value) : Parameter(_name, REAL8), value(_value) { }
-
-	~Real8Parameter() { }
-
-	double get_value() const {
-		return value;
+	void add_uint8(const ParameterName & name, uint8_t value) {
+		add_value(name, UINT8, value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_uint16(const ParameterName & name, uint16_t value) {
+		add_value(name, UINT16, value);
 	}
 
-protected:
-	double value;
-};
-
-struct Complex8Parameter : Parameter {
-public:
-	Complex8Parameter(string _name, std::complex<float> _value) : Parameter(_name, COMPLEX8), value(0) { value = _value; }
-
-	~Complex8Parameter() {}
-
-	std::complex<float> get_value() const {
-		return value;
+	void add_uint32(const ParameterName & name, uint32_t value) {
+		add_value(name, UINT32, value);
 	}
 
-	string to_string() const {
-		stringstream ss;
-
-		ss << value;
-
-		return ss.str();
+	void add_uint64(const ParameterName & name, uint64_t value) {
+		add_value(name, UINT64, value);
 	}
 
-protected:
-	std::complex<float> value;
-};
-
-struct Complex16Parameter : Parameter {
-public:
-	Complex16Parameter(string _name, std::complex<double> _value) : Parameter(_name, COMPLEX16), value(0) { value = _value; }
-
-	~Complex16Parameter() {}
-
-	std::complex<double> get_value() const {
-		return value;
+	void add_float_int(const ParameterName & name, uint32_t value) {
+		add_value(name, INT32, (int32_t) value);
 	}
 
-	string to_string() const {
-		stringstream ss;
-
-		ss << value;
-
-		return ss.str();
+	void add_double_int(const ParameterName & name, uint64_t value) {
+		add_value(name, INT64, (int64_t) value);
 	}
 
-protected:
-	std::complex<double> value;
-};
-
-struct Integer1Parameter : Parameter {
-public:
-	Integer1Parameter(string _name, int8_t _value) : Parameter(_name, INTEGER1), value(_value) { }
-
-	~Integer1Parameter() { }
-
-	int8_t get_value() const {
-		return value;
+	void add_long_int(const ParameterName & name, long int value) {
+		add_value(name, INT64, (int64_t) value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_short_int(const ParameterName & name, short int value) {
+		add_value(name, INT16, (int16_t) value);
 	}
 
-protected:
-	int8_t value;
-};
-
-struct Integer2Parameter : Parameter {
-public:
-	Integer2Parameter(string _name, int16_t _value) : Parameter(_name, INTEGER2), value(_value) { }
-
-	~Integer2Parameter() { }
-
-	int16_t get_value() const {
-		return value;
+	void add_long_double_int(const ParameterName & name, uint64_t value) {
+		add_value(name, INT64, (int64_t) value);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_string(const ParameterName & name, const string & value) {
+		add_array(name, STRING, ArraySpan<char>(value.data(), value.length()), true);
 	}
 
-protected:
-	int16_t value;
-};
-
-struct Integer4Parameter : Parameter {
-public:
-	Integer4Parameter(string _name, int32_t _value) : Parameter(_name, INTEGER4), value(_value) { }
-
-	~Integer4Parameter() { }
-
-	int32_t get_value() const {
-		return value;
+	void add_string_view(const ParameterName & name, const ArraySpan<char> & value) {
+		add_array(name, STRING, value, false);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_wstring(const ParameterName & name, const string & value) {
+		add_array(name, WSTRING, ArraySpan<char>(value.data(), value.length()), true);
 	}
 
-protected:
-	int32_t value;
-};
-
-struct Integer8Parameter : Parameter {
-public:
-	Integer8Parameter(string _name, int64_t _value) : Parameter(_name, INTEGER8), value(_value) { }
-
-	~Integer8Parameter() { }
-
-	int64_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int64_t value;
-};
-
-struct Int8Parameter : Parameter {
-public:
-	Int8Parameter(string _name, int8_t _value) : Parameter(_name, INT8), value(_value) { }
-
-	~Int8Parameter() { }
-
-	int8_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int8_t value;
-};
-
-struct Int16Parameter : Parameter {
-public:
-	Int16Parameter(string _name, int16_t _value) : Parameter(_name, INT16), value(_value) { }
-
-	~Int16Parameter() { }
-
-	int16_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int16_t value;
-};
-
-struct Int32Parameter : Parameter {
-public:
-	Int32Parameter(string _name, int32_t _value) : Parameter(_name, INT32), value(_value) { }
-
-	~Int32Parameter() { }
-
-	int32_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int32_t value;
-};
-
-struct Int64Parameter : Parameter {
-public:
-	Int64Parameter(string _name, int64_t _value) : Parameter(_name, INT64), value(_value) { }
-
-	~Int64Parameter() { }
-
-	int64_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int64_t value;
-};
-
-struct UInt8Parameter : Parameter {
-public:
-	UInt8Parameter(string _name, uint8_t _value) : Parameter(_name, UINT8), value(_value) { }
-
-	~UInt8Parameter() { }
-
-	uint8_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
+	void add_int16_array(const ParameterName & name, const ArraySpan<int16_t> & value) {
+		add_array(name, INT16_ARRAY, value, true);
 	}
 
-protected:
-	uint8_t value;
-};
-
-struct UInt16Parameter : Parameter {
-public:
-	UInt16Parameter(string _name, uint16_t _value) : Parameter(_name, UINT16), value(_value) { }
-
-	~UInt16Parameter() { }
-
-	uint16_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	uint16_t value;
-};
-
-struct UInt32Parameter : Parameter {
-public:
-	UInt32Parameter(string _name, uint32_t _value) : Parameter(_name, UINT32), value(_value) { }
-
-	~UInt32Parameter() { }
-
-	uint32_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	uint32_t value;
-};
-
-struct UInt64Parameter : Parameter {
-public:
-	UInt64Parameter(string _name, uint64_t _value) : Parameter(_name, UINT64), value(_value) { }
-
-	~UInt64Parameter() { }
-
-	uint64_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
+	void add_int16_array_view(const ParameterName & name, const ArraySpan<int16_t> & value) {
+		add_array(name, INT16_ARRAY, value, false);
 	}
 
-protected:
-	uint64_t value;
-};
-
-struct FloatIntParameter : Parameter {
-public:
-	FloatIntParameter(string _name, int32_t _value) : Parameter(_name, INT32), value(_value) { }
-
-	~FloatIntParameter() { }
-
-	int32_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int32_t value;
-};
-
-struct DoubleIntParameter : Parameter {
-public:
-	DoubleIntParameter(string _name, int64_t _value) : Parameter(_name, INT64), value(_value) { }
-
-	~DoubleIntParameter() { }
-
-	int64_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
-	}
-
-protected:
-	int64_t value;
-};
-
-struct ShortIntParameter : Parameter {
-public:
-	ShortIntParameter(string _name, int16_t _value) : Parameter(_name, INT16), value(_value) { }
-
-	~ShortIntParameter() { }
-
-	int16_t get_value() const {
-		return value;
-	}
-
-	string to_string() const {
-		return std::to_string(value);
+	void add_int32_array(const ParameterName & name, const ArraySpan<int32_t> & value) {
+		add_array(name, INT32_ARRAY, value, true);
 	}
 
-protected:
-	int16_t value;
-};
-
-struct LongIntParameter : Parameter {
-public:
-	LongIntParameter(string _name, int64_t _value) : Parameter(_name, INT64), value(_value) { }
-
-	~LongIntParameter() { }
-
-	int64_t get_value() const {
-		return value;
+	void add_int32_array_view(const ParameterName & name, const ArraySpan<int32_t> & value) {
+		add_array(name, INT32_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_int64_array(const ParameterName & name, const ArraySpan<int64_t> & value) {
+		add_array(name, INT64_ARRAY, value, true);
 	}
 
-protected:
-	int64_t value;
-};
-
-struct LongDoubleIntParameter : Parameter {
-public:
-	LongDoubleIntParameter(string _name, int64_t _value) : Parameter(_name, INT64), value(_value) { }
-
-	~LongDoubleIntParameter() { }
-
-	int64_t get_value() const {
-		return value;
+	void add_int64_array_view(const ParameterName & name, const ArraySpan<int64_t> & value) {
+		add_array(name, INT64_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		return std::to_string(value);
+	void add_uint16_array(const ParameterName & name, const ArraySpan<uint16_t> & value) {
+		add_array(name, UINT16_ARRAY, value, true);
 	}
 
-protected:
-	int64_t value;
-};
-
-struct StringParameter : Parameter {
-public:
-	StringParameter(string _name, string _value) : Parameter(_name, STRING), value(_value) { }
-
-	~StringParameter() {}
-
-	string get_value() const {
-		return value;
+	void add_uint16_array_view(const ParameterName & name, const ArraySpan<uint16_t> & value) {
+		add_array(name, UINT16_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		return value;
+	void add_uint32_array(const ParameterName & name, const ArraySpan<uint32_t> & value) {
+		add_array(name, UINT32_ARRAY, value, true);
 	}
 
-protected:
-	string value;
-};
-
-struct WStringParameter : Parameter {
-public:
-	WStringParameter(string _name, string _value) : Parameter(_name, WSTRING), value(_value) { }
-
-	~WStringParameter() {}
-
-	string get_value() const {
-		return value;
+	void add_uint32_array_view(const ParameterName & name, const ArraySpan<uint32_t> & value) {
+		add_array(name, UINT32_ARRAY, value, false);
 	}
 
-	string to_string() const {
-//		stringstream ss;
-//
-//		std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-//
-//		ss << converter.to_bytes(value);
-
-		return value;
+	void add_uint64_array(const ParameterName & name, const ArraySpan<uint64_t> & value) {
+		add_array(name, UINT64_ARRAY, value, true);
 	}
 
-protected:
-	string value;
-};
-
-struct ArrayInfoParameter : Parameter {
-public:
-
-	ArrayInfoParameter(string _name, ArrayInfo_ptr _value) : Parameter(_name, ARRAY_INFO), value(_value) { }
-
-	~ArrayInfoParameter() { }
-
-	ArrayInfo_ptr get_value() const {
-		return value;
+	void add_uint64_array_view(const ParameterName & name, const ArraySpan<uint64_t> & value) {
+		add_array(name, UINT64_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		return value->to_string();
+	void add_float_array(const ParameterName & name, const ArraySpan<float> & value) {
+		add_array(name, FLOAT_ARRAY, value, true);
 	}
 
-protected:
-	ArrayInfo_ptr value;
-};
-
-struct DistMatrixParameter : Parameter {
-public:
-
-	DistMatrixParameter(string _name, DistMatrix_ptr _value) : Parameter(_name, DISTMATRIX), value(_value) {}
-
-	~DistMatrixParameter() {}
-
-	DistMatrix_ptr get_value() const {
-		return value;
+	void add_float_array_view(const ParameterName & name, const ArraySpan<float> & value) {
+		add_array(name, FLOAT_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		std::stringstream ss;
-		ss << value;
-		return ss.str();
+	void add_double_array(const ParameterName & name, const ArraySpan<double> & value) {
+		add_array(name, DOUBLE_ARRAY, value, true);
 	}
 
-protected:
-	DistMatrix_ptr value;
-};
-
-struct PointerParameter : Parameter {
-public:
-
-	PointerParameter(string _name, void * _value) : Parameter(_name, VOID_POINTER), value(_value) {}
-
-	~PointerParameter() {}
-
-	void * get_value() const {
-		return value;
+	void add_double_array_view(const ParameterName & name, const ArraySpan<double> & value) {
+		add_array(name, DOUBLE_ARRAY, value, false);
 	}
 
-	string to_string() const {
-		std::stringstream ss;
-		ss << value;
-		return ss.str();
+	void add_string_array(const ParameterName & name, const std::vector<string> & value) {
+		add_shared(name, STRING_ARRAY, string_arrays, value);
 	}
 
-protected:
-	void * value;
-};
-
-struct Parameters {
-public:
-	Parameters() : current_parameter_count(0), current_distmatrix_count(0) { }
-
-	~Parameters() { }
-
-	std::vector<string> distmatrix_names;
-	std::vector<string> matrix_info_names;
-	std::vector<string> ptr_names;
-
-	uint32_t current_parameter_count;
-	std::map<std::string, std::shared_ptr<Parameter> >::iterator it;
-
-	uint8_t current_distmatrix_count;
-	std::vector<std::string>::iterator distmatrix_it;
-
-	datatype get_next_parameter()
-	{
-		datatype _dt = NONE;
-
-		if (current_parameter_count == 0) it = parameters.begin();
-		else it++;
-
-		if (it != parameters.end()) {
-			current_parameter_count++;
-			_dt = it->second->dt;
-		}
-
-		return _dt;
+	void add_local_matrix(const ParameterName & name, LocalMatrix_ptr value) {
+		add_shared(name, LOCAL_MATRIX, local_matrices, value);
 	}
 
-	void get_next_distmatrix(string & distmatrix_name, DistMatrix_ptr & distmatrix_ptr)
-	{
-		distmatrix_name = "";
-		distmatrix_ptr = nullptr;
-
-		if (current_distmatrix_count == 0) distmatrix_it = distmatrix_names.begin();
-		else distmatrix_it++;
-
-		if (distmatrix_it != distmatrix_names.end()) {
-			current_distmatrix_count++;
-			distmatrix_name = *distmatrix_it;
-			distmatrix_ptr = get_distmatrix(*distmatrix_it);
-		}
+	void add_matrix_info(const ParameterName & name, const ArrayInfo_ptr value) {
+		add_shared(name, ARRAY_INFO, matrix_infos, value);
 	}
 
-	std::string get_name() {
-		return it->second->get_name();
+	void add_distmatrix(const ParameterName & name, DistMatrix_ptr value) {
+		add_shared(name, DISTMATRIX, distmatrices, value);
 	}
 
-	uint8_t num_distmatrices() {
-		return (uint8_t) distmatrix_names.size();
+	void add_ptr(const ParameterName & name, void * value) {
+		add_value(name, VOID_POINTER, value);
 	}
 
-	uint8_t num_matrix_infos() {
-		return (uint8_t) matrix_info_names.size();
+	int get_char(const ParameterName & name) const {
+		return get_value<char>(name, CHAR);
 	}
 
-	uint8_t num_void_pointers() {
-		return (uint8_t) ptr_names.size();
+	signed char get_signed_char(const ParameterName & name) const {
+		return get_value<signed char>(name, SIGNED_CHAR);
 	}
 
-	int num() const {
-		return parameters.size();
+	unsigned char get_unsigned_char(const ParameterName & name) const {
+		return get_value<unsigned char>(name, UNSIGNED_CHAR);
 	}
 
-//	size_t num_distmatrices() const {
-//		return distmatrix_parameters.size();
-//	}
-
-	void add(Parameter * p) {
-		parameters.insert(std::make_pair(p->get_name(), p));
+	char get_character(const ParameterName & name) const {
+		return get_value<char>(name, CHARACTER);
 	}
 
-	std::shared_ptr<Parameter> get(string name) const {
-		return parameters.find(name)->second;
+	wchar_t get_wchar(const ParameterName & name) const {
+		return get_value<wchar_t>(name, WCHAR);
 	}
 
-	void add_char(string name, char value) {
-		parameters.insert(std::make_pair(name, new CharParameter(name, value)));
+	short get_short(const ParameterName & name) const {
+		return get_value<short>(name, SHORT);
 	}
 
-	void add_signed_char(string name, signed char value) {
-		parameters.insert(std::make_pair(name, new SignedCharParameter(name, value)));
+	unsigned short get_unsigned_short(const ParameterName & name) const {
+		return get_value<unsigned short>(name, UNSIGNED_SHORT);
 	}
 
-	void add_unsigned_char(string name, unsigned char value) {
-		parameters.insert(std::make_pair(name, new UnsignedCharParameter(name, value)));
+	int get_int(const ParameterName & name) const {
+		return get_value<int>(name, INT);
 	}
 
-	void add_character(string name, char value) {
-		parameters.insert(std::make_pair(name, new CharacterParameter(name, value)));
+	unsigned get_unsigned(const ParameterName & name) const {
+		return get_value<unsigned int>(name, UNSIGNED);
 	}
 
-	void add_wchar(string name, wchar_t value) {
-		parameters.insert(std::make_pair(name, new WcharParameter(name, value)));
+	long get_long(const ParameterName & name) const {
+		return get_value<long>(name, LONG);
 	}
 
-	void add_short(string name, short value) {
-		parameters.insert(std::make_pair(name, new ShortParameter(name, value)));
+	unsigned long get_unsigned_long(const ParameterName & name) const {
+		return get_value<unsigned long>(name, UNSIGNED_LONG);
 	}
 
-	void add_unsigned_short(string name, unsigned short value) {
-		parameters.insert(std::make_pair(name, new UnsignedShortParameter(name, value)));
+	long long int get_long_long_int(const ParameterName & name) const {
+		return get_value<long long int>(name, LONG_LONG_INT);
 	}
 
-	void add_int(string name, int value) {
-		parameters.insert(std::make_pair(name, new IntParameter(name, value)));
+	long long get_long_long(const ParameterName & name) const {
+		return get_value<long long int>(name, LONG_LONG);
 	}
 
-	void add_unsigned(string name, unsigned int value) {
-		parameters.insert(std::make_pair(name, new UnsignedParameter(name, value)));
+	unsigned long long get_unsigned_long_long(const ParameterName & name) const {
+		return get_value<unsigned long long int>(name, UNSIGNED_LONG_LONG);
 	}
 
-	void add_long(string name, long value) {
-		parameters.insert(std::make_pair(name, new LongParameter(name, value)));
+	float get_float(const ParameterName & name) const {
+		return get_value<float>(name, FLOAT);
 	}
 
-	void add_unsigned_long(string name, unsigned long value) {
-		parameters.insert(std::make_pair(name, new UnsignedLongParameter(name, value)));
+	double get_double(const ParameterName & name) const {
+		return get_value<double>(name, DOUBLE);
 	}
 
-	void add_long_long_int(string name, long long int value) {
-		parameters.insert(std::make_pair(name, new LongLongIntParameter(name, value)));
+	long double get_long_double(const ParameterName & name) const {
+		return get_value<long double>(name, LONG_DOUBLE);
 	}
 
-	void add_long_long(string name, long long int value) {
-		parameters.insert(std::make_pair(name, new LongLongParameter(name, value)));
+	unsigned char get_byte(const ParameterName & name) const {
+		return get_value<uint8_t>(name, BYTE);
 	}
 
-	void add_unsigned_long_long(string name, unsigned long long int value) {
-		parameters.insert(std::make_pair(name, new UnsignedLongLongParameter(name, value)));
+	bool get_bool(const ParameterName & name) const {
+		return get_value<bool>(name, BOOL);
 	}
 
-	void add_float(string name, float value) {
-		parameters.insert(std::make_pair(name, new FloatParameter(name, value)));
+	int get_integer(const ParameterName & name) const {
+		return get_value<int>(name, INTEGER);
 	}
 
-	void add_double(string name, double value) {
-		parameters.insert(std::make_pair(name, new DoubleParameter(name, value)));
+	double get_real(const ParameterName & name) const {
+		return get_value<double>(name, REAL);
 	}
 
-	void add_long_double(string name, long double value) {
-		parameters.insert(std::make_pair(name, new LongDoubleParameter(name, value)));
+	bool get_logical(const ParameterName & name) const {
+		return get_value<bool>(name, LOGICAL);
 	}
 
-	void add_byte(string name, uint8_t value) {
-		parameters.insert(std::make_pair(name, new ByteParameter(name, value)));
+	std::complex<double> get_complex(const ParameterName & name) const {
+		return get_value<std::complex<double>>(name, COMPLEX);
 	}
 
-	void add_bool(string name, bool value) {
-		parameters.insert(std::make_pair(name, new BoolParameter(name, value)));
+	double get_double_precision(const ParameterName & name) const {
+		return get_value<double>(name, DOUBLE_PRECISION);
 	}
 
-	void add_integer(string name, int value) {
-		parameters.insert(std::make_pair(name, new IntegerParameter(name, value)));
+	float get_real4(const ParameterName & name) const {
+		return get_value<float>(name, REAL4);
 	}
 
-	void add_real(string name, double value) {
-		parameters.insert(std::make_pair(name, new RealParameter(name, value)));
+	std::complex<float> get_complex8(const ParameterName & name) const {
+		return get_value<std::complex<float>>(name, COMPLEX8);
 	}
 
-	void add_logical(string name, bool value) {
-		parameters.insert(std::make_pair(name, new LogicalParameter(name, value)));
+	double get_real8(const ParameterName & name) const {
+		return get_value<double>(name, REAL8);
 	}
 
-	void add_complex(string name, std::complex<double> value) {
-		parameters.insert(std::make_pair(name, new ComplexParameter(name, value)));
+	std::complex<double> get_complex16(const ParameterName & name) const {
+		return get_value<std::complex<double>>(name, COMPLEX16);
 	}
 
-	void add_double_precision(string name, double value) {
-		parameters.insert(std::make_pair(name, new DoublePrecisionParameter(name, value)));
+	int8_t get_integer1(const ParameterName & name) const {
+		return get_value<int8_t>(name, INTEGER1);
 	}
 
-	void add_real4(string name, float value) {
-		parameters.insert(std::make_pair(name, new Real4Parameter(name, value)));
+	int16_t get_integer2(const ParameterName & name) const {
+		return get_value<int16_t>(name, INTEGER2);
 	}
 
-	void add_complex8(string name, std::complex<float> value) {
-		parameters.insert(std::make_pair(name, new Complex8Parameter(name, value)));
+	int32_t get_integer4(const ParameterName & name) const {
+		return get_value<int32_t>(name, INTEGER4);
 	}
 
-	void add_real8(string name, double value) {
-		parameters.insert(std::make_pair(name, new Real8Parameter(name, value)));
+	int64_t get_integer8(const ParameterName & name) const {
+		return get_value<int64_t>(name, INTEGER8);
 	}
 
-	void add_complex16(string name, std::complex<double> value) {
-		parameters.insert(std::make_pair(name, new Complex16Parameter(name, value)));
+	int8_t get_int8(const ParameterName & name) const {
+		return get_value<int8_t>(name, INT8);
 	}
 
-	void add_integer1(string name, int8_t value) {
-		parameters.insert(std::make_pair(name, new Integer1Parameter(name, value)));
+	int16_t get_int16(const ParameterName & name) const {
+		return get_value<int16_t>(name, INT16);
 	}
 
-	void add_integer2(string name, int16_t value) {
-		parameters.insert(std::make_pair(name, new Integer2Parameter(name, value)));
+	int32_t get_int32(const ParameterName & name) const {
+		return get_value<int32_t>(name, INT32);
 	}
 
-	void add_integer4(string name, int32_t value) {
-		parameters.insert(std::make_pair(name, new Integer4Parameter(name, value)));
+	int64_t get_int64(const ParameterName & name) const {
+		return get_value<int64_t>(name, INT64);
 	}
 
-	void add_integer8(string name, int64_t value) {
-		parameters.insert(std::make_pair(name, new Integer8Parameter(name, value)));
+	uint8_t get_uint8(const ParameterName & name) const {
+		return get_value<uint8_t>(name, UINT8);
 	}
 
-	void add_int8(string name, int8_t value) {
-		parameters.insert(std::make_pair(name, new Int8Parameter(name, value)));
+	uint16_t get_uint16(const ParameterName & name) const {
+		return get_value<uint16_t>(name, UINT16);
 	}
 
-	void add_int16(string name, int16_t value) {
-		parameters.insert(std::make_pair(name, new Int16Parameter(name, value)));
+	uint32_t get_uint32(const ParameterName & name) const {
+		return get_value<uint32_t>(name, UINT32);
 	}
 
-	void add_int32(string name, int32_t value) {
-		parameters.insert(std::make_pair(name, new Int32Parameter(name, value)));
+	uint64_t get_uint64(const ParameterName & name) const {
+		return get_value<uint64_t>(name, UINT64);
 	}
 
-	void add_int64(string name, int64_t value) {
-		parameters.insert(std::make_pair(name, new Int64Parameter(name, value)));
+	uint32_t get_float_int(const ParameterName & name) const {
+		return (uint32_t) get_value<int32_t>(name, INT32);
 	}
 
-	void add_uint8(string name, uint8_t value) {
-		parameters.insert(std::make_pair(name, new UInt8Parameter(name, value)));
+	uint64_t get_double_int(const ParameterName & name) const {
+		return (uint64_t) get_value<int64_t>(name, INT64);
 	}
 
-	void add_uint16(string name, uint16_t value) {
-		parameters.insert(std::make_pair(name, new UInt16Parameter(name, value)));
+	long int get_long_int(const ParameterName & name) const {
+		return (long int) get_value<int64_t>(name, INT64);
 	}
 
-	void add_uint32(string name, uint32_t value) {
-		parameters.insert(std::make_pair(name, new UInt32Parameter(name, value)));
+	short int get_short_int(const ParameterName & name) const {
+		return (short int) get_value<int16_t>(name, INT16);
 	}
 
-	void add_uint64(string name, uint64_t value) {
-		parameters.insert(std::make_pair(name, new UInt64Parameter(name, value)));
+	uint64_t get_long_double_int(const ParameterName & name) const {
+		return (uint64_t) get_value<int64_t>(name, INT64);
 	}
 
-	void add_float_int(string name, uint32_t value) {
-		parameters.insert(std::make_pair(name, new FloatIntParameter(name, value)));
+	string get_string(const ParameterName & name) const {
+		ArraySpan<char> value = get_value<ArraySpan<char>>(name, STRING);
+		return string(value.data(), value.size());
 	}
 
-	void add_double_int(string name, uint64_t value) {
-		parameters.insert(std::make_pair(name, new DoubleIntParameter(name, value)));
+	ArraySpan<char> get_string_span(const ParameterName & name) const {
+		return get_value<ArraySpan<char>>(name, STRING);
 	}
 
-	void add_long_int(string name, long int value) {
-		parameters.insert(std::make_pair(name, new LongIntParameter(name, value)));
+	string get_wstring(const ParameterName & name) const {
+		ArraySpan<char> value = get_value<ArraySpan<char>>(name, WSTRING);
+		return string(value.data(), value.size());
 	}
 
-	void add_short_int(string name, short int value) {
-		parameters.insert(std::make_pair(name, new ShortIntParameter(name, value)));
+	ArraySpan<int16_t> get_int16_array(const ParameterName & name) const {
+		return get_value<ArraySpan<int16_t>>(name, INT16_ARRAY);
 	}
 
-	void add_long_double_int(string name, uint64_t value) {
-		parameters.insert(std::make_pair(name, new LongDoubleIntParameter(name, value)));
+	ArraySpan<int32_t> get_int32_array(const ParameterName & name) const {
+		return get_value<ArraySpan<int32_t>>(name, INT32_ARRAY);
 	}
 
-	void add_string(string name, string value) {
-		parameters.insert(std::make_pair(name, new StringParameter(name, value)));
+	ArraySpan<int64_t> get_int64_array(const ParameterName & name) const {
+		return get_value<ArraySpan<int64_t>>(name, INT64_ARRAY);
 	}
 
-	void add_wstring(string name, string value) {
-		parameters.insert(std::make_pair(name, new WStringParameter(name, value)));
+	ArraySpan<uint16_t> get_uint16_array(const ParameterName & name) const {
+		return get_value<ArraySpan<uint16_t>>(name, UINT16_ARRAY);
 	}
 
-	void add_matrix_info(string name, const ArrayInfo_ptr value) {
-		matrix_info_names.push_back(name);
-		parameters.insert(std::make_pair(name, new ArrayInfoParameter(name, value)));
+	ArraySpan<uint32_t> get_uint32_array(const ParameterName & name) const {
+		return get_value<ArraySpan<uint32_t>>(name, UINT32_ARRAY);
 	}
 
-	void add_distmatrix(string name, DistMatrix_ptr value) {
-		distmatrix_names.push_back(name);
-		parameters.insert(std::make_pair(name, new DistMatrixParameter(name, value)));
+	ArraySpan<uint64_t> get_uint64_array(const ParameterName & name) const {
+		return get_value<ArraySpan<uint64_t>>(name, UINT64_ARRAY);
 	}
 
-	void add_ptr(string name, void * value) {
-		ptr_names.push_back(name);
-		parameters.insert(std::make_pair(name, new PointerParameter(name, value)));
+	ArraySpan<float> get_float_array(const ParameterName & name) const {
+		return get_value<ArraySpan<float>>(name, FLOAT_ARRAY);
 	}
 
-	int get_char(string name) const {
-		return std::dynamic_pointer_cast<CharParameter> (parameters.find(name)->second)->get_value();
+	ArraySpan<double> get_double_array(const ParameterName & name) const {
+		return get_value<ArraySpan<double>>(name, DOUBLE_ARRAY);
 	}
 
-	signed char get_signed_char(string name) const {
-		return std::dynamic_pointer_cast<SignedCharParameter> (parameters.find(name)->second)->get_value();
+	const std::vector<string> & get_string_array(const ParameterName & name) const {
+		return string_arrays[get_value<uint32_t>(name, STRING_ARRAY)];
 	}
 
-	unsigned char get_unsigned_char(string name) const {
-		return std::dynamic_pointer_cast<UnsignedCharParameter> (parameters.find(name)->second)->get_value();
+	LocalMatrix_ptr get_local_matrix(const ParameterName & name) const {
+		return local_matrices[get_value<uint32_t>(name, LOCAL_MATRIX)];
 	}
 
-	unsigned char get_byte(string name) const {
-		return std::dynamic_pointer_cast<ByteParameter> (parameters.find(name)->second)->get_value();
+	ArrayInfo_ptr get_matrix_info(const ParameterName & name) const {
+		return matrix_infos[get_value<uint32_t>(name, ARRAY_INFO)];
 	}
 
-	bool get_bool(string name) const {
-		return std::dynamic_pointer_cast<BoolParameter> (parameters.find(name)->second)->get_value();
+	DistMatrix_ptr get_distmatrix(const ParameterName & name) const {
+		return distmatrices[get_value<uint32_t>(name, DISTMATRIX)];
 	}
 
-	bool get_logical(string name) const {
-		return std::dynamic_pointer_cast<LogicalParameter> (parameters.find(name)->second)->get_value();
+	void * get_ptr(const ParameterName & name) const {
+		return get_value<void *>(name, VOID_POINTER);
 	}
 
-	int get_int(string name) const {
-		return std::dynamic_pointer_cast<IntParameter> (parameters.find(name)->second)->get_value();
-	}
+	string to_string() const {
+		std::stringstream arg_list;
 
-	int8_t get_integer1(string name) const {
-		return std::dynamic_pointer_cast<Integer1Parameter> (parameters.find(name)->second)->get_value();
-	}
+		for (uint32_t i = 0; i < num_entries; i++) {
+			const Entry & e = entry(i);
+			arg_list << string(e.name, e.name_length) << " (" << (uint16_t) e.dt << "): " << value_to_string(e) << std::endl;
+		}
 
-	int16_t get_integer2(string name) const {
-		return std::dynamic_pointer_cast<Integer2Parameter> (parameters.find(name)->second)->get_value();
+		return arg_list.str();
 	}
 
-	int32_t get_integer4(string name) const {
-		return std::dynamic_pointer_cast<Integer4Parameter> (parameters.find(name)->second)->get_value();
-	}
+private:
+	enum { inline_capacity = 16 };
 
-	int64_t get_integer8(string name) const {
-		return std::dynamic_pointer_cast<Integer8Parameter> (parameters.find(name)->second)->get_value();
-	}
+	struct Entry {
+		const char * name;
+		uint32_t name_length;
+		datatype dt;
+		alignas(16) char value[16];
+	};
 
-	int8_t get_int8(string name) const {
-		return std::dynamic_pointer_cast<Int8Parameter> (parameters.find(name)->second)->get_value();
-	}
+	// The first inline_capacity entries live in the object itself, so a typical task never allocates for them
+	Entry inline_entries[inline_capacity];
+	std::vector<Entry> overflow_entries;
+	uint32_t num_entries;
 
-	int16_t get_int16(string name) const {
-		return std::dynamic_pointer_cast<Int16Parameter> (parameters.find(name)->second)->get_value();
-	}
+	Arena arena;
 
-	int32_t get_int32(string name) const {
-		return std::dynamic_pointer_cast<Int32Parameter> (parameters.find(name)->second)->get_value();
-	}
+	std::vector<ArrayInfo_ptr> matrix_infos;
+	std::vector<DistMatrix_ptr> distmatrices;
+	std::vector<LocalMatrix_ptr> local_matrices;
+	std::vector<std::vector<string>> string_arrays;
+	uint8_t num_pointers;
 
-	int64_t get_int64(string name) const {
-		return std::dynamic_pointer_cast<Int64Parameter> (parameters.find(name)->second)->get_value();
-	}
+	uint32_t current_parameter_count;
+	uint32_t current_distmatrix_count;
 
-	uint8_t get_uint8(string name) const {
-		return std::dynamic_pointer_cast<UInt8Parameter> (parameters.find(name)->second)->get_value();
+	Entry & entry(uint32_t i) {
+		return (i < inline_capacity) ? inline_entries[i] : overflow_entries[i - inline_capacity];
 	}
 
-	uint16_t get_uint16(string name) const {
-		return std::dynamic_pointer_cast<UInt16Parameter> (parameters.find(name)->second)->get_value();
+	const Entry & entry(uint32_t i) const {
+		return (i < inline_capacity) ? inline_entries[i] : overflow_entries[i - inline_capacity];
 	}
 
-	uint32_t get_uint32(string name) const {
-		return std::dynamic_pointer_cast<UInt32Parameter> (parameters.find(name)->second)->get_value();
-	}
+	const Entry * find(const ParameterName & name) const {
+		for (uint32_t i = 0; i < num_entries; i++) {
+			const Entry & e = entry(i);
+			if (e.name_length == name.length && memcmp(e.name, name.ptr, name.length) == 0) return &e;
+		}
 
-	uint64_t get_uint64(string name) const {
-		return std::dynamic_pointer_cast<UInt64Parameter> (parameters.find(name)->second)->get_value();
+		return nullptr;
 	}
 
-	long get_long(string name) const {
-		return std::dynamic_pointer_cast<LongParameter> (parameters.find(name)->second)->get_value();
-	}
+	// Returns nullptr if there already is a parameter with the given name
+	Entry * add_entry(const ParameterName & name, const datatype dt) {
+		if (find(name) != nullptr) return nullptr;
 
-	long long get_long_long(string name) const {
-		return std::dynamic_pointer_cast<LongLongParameter> (parameters.find(name)->second)->get_value();
-	}
+		Entry * e;
+		if (num_entries < inline_capacity) e = &inline_entries[num_entries];
+		else {
+			overflow_entries.emplace_back();
+			e = &overflow_entries.back();
+		}
+		num_entries++;
 
-	unsigned get_unsigned(string name) const {
-		return std::dynamic_pointer_cast<UnsignedParameter> (parameters.find(name)->second)->get_value();
-	}
+		e->name = name.copy ? arena.copy(name.ptr, name.length) : name.ptr;
+		e->name_length = (uint32_t) name.length;
+		e->dt = dt;
+		if (dt == VOID_POINTER) num_pointers++;
 
-	unsigned long get_unsigned_long(string name) const {
-		return std::dynamic_pointer_cast<UnsignedLongParameter> (parameters.find(name)->second)->get_value();
+		return e;
 	}
 
-	unsigned long long get_unsigned_long_long(string name) const {
-		return std::dynamic_pointer_cast<UnsignedLongLongParameter> (parameters.find(name)->second)->get_value();
-	}
+	template <typename T>
+	void add_value(const ParameterName & name, const datatype dt, const T & value) {
+		static_assert(sizeof(T) <= sizeof(Entry::value), "Parameter value does not fit in a table entry");
 
-	float get_float(string name) const {
-		return std::dynamic_pointer_cast<FloatParameter> (parameters.find(name)->second)->get_value();
+		Entry * e = add_entry(name, dt);
+		if (e != nullptr) memcpy(e->value, &value, sizeof(T));
 	}
 
-	double get_double(string name) const {
-		return std::dynamic_pointer_cast<DoubleParameter> (parameters.find(name)->second)->get_value();
+	template <typename T>
+	void add_array(const ParameterName & name, const datatype dt, const ArraySpan<T> & value, const bool copy) {
+		if (copy && find(name) == nullptr) add_value(name, dt, ArraySpan<T>(arena.copy(value.data(), value.size()), value.size()));
+		else add_value(name, dt, value);
 	}
 
-	long double get_long_double(string name) const {
-		return std::dynamic_pointer_cast<LongDoubleParameter> (parameters.find(name)->second)->get_value();
-	}
+	template <typename T>
+	void add_shared(const ParameterName & name, const datatype dt, std::vector<T> & table, const T & value) {
+		if (find(name) != nullptr) return;
 
-	std::string get_string(std::string name) const {
-		return std::dynamic_pointer_cast<StringParameter>(parameters.find(name)->second)->get_value();
+		table.push_back(value);
+		add_value(name, dt, (uint32_t) (table.size() - 1));
 	}
 
-	ArrayInfo_ptr get_matrix_info(string name) const {
-		return std::dynamic_pointer_cast<ArrayInfoParameter>(parameters.find(name)->second)->get_value();
+	template <typename T>
+	static T get_value_at(const Entry & e) {
+		T value;
+		memcpy(&value, e.value, sizeof(T));
+		return value;
 	}
 
-	DistMatrix_ptr get_distmatrix(string name) const {
-		return std::dynamic_pointer_cast<DistMatrixParameter>(parameters.find(name)->second)->get_value();
-	}
+	template <typename T>
+	T get_value(const ParameterName & name, const datatype dt) const {
+		const Entry * e = find(name);
+		if (e == nullptr) {
+			std::cerr << "ERROR: Unknown parameter '" << string(name.ptr, name.length) << "'" << std::endl;
+			throw std::exception();
+		}
+		if (e->dt != dt) {
+			std::cerr << "ERROR: Parameter '" << string(name.ptr, name.length) << "' is " << get_datatype_name(e->dt)
+					<< ", not " << get_datatype_name(dt) << std::endl;
+			throw std::exception();
+		}
 
-	void * get_ptr(string name) const {
-		return std::dynamic_pointer_cast<PointerParameter>(parameters.find(name)->second)->get_value();
+		return get_value_at<T>(*e);
 	}
 
-	string to_string() const {
-		std::stringstream arg_list;
+	string value_to_string(const Entry & e) const {
+		std::stringstream ss;
 
-		for (auto it = parameters.begin(); it != parameters.end(); it++ ) {
-			arg_list << it->first << " (" << it->second->dt << "): "<< it->second->to_string() << std::endl;
+		switch (e.dt) {
+			case CHAR:
+			case CHARACTER:
+				ss << get_value_at<char>(e);
+				break;
+			case SIGNED_CHAR:
+			case INTEGER1:
+			case INT8:
+				ss << (int16_t) get_value_at<int8_t>(e);
+				break;
+			case UNSIGNED_CHAR:
+			case BYTE:
+			case UINT8:
+				ss << (uint16_t) get_value_at<uint8_t>(e);
+				break;
+			case WCHAR:
+				ss << (uint32_t) get_value_at<wchar_t>(e);
+				break;
+			case SHORT:
+			case INTEGER2:
+			case INT16:
+				ss << get_value_at<int16_t>(e);
+				break;
+			case UNSIGNED_SHORT:
+			case UINT16:
+				ss << get_value_at<uint16_t>(e);
+				break;
+			case INT:
+			case INTEGER:
+			case INTEGER4:
+			case INT32:
+				ss << get_value_at<int32_t>(e);
+				break;
+			case UNSIGNED:
+			case UINT32:
+				ss << get_value_at<uint32_t>(e);
+				break;
+			case LONG:
+				ss << get_value_at<long>(e);
+				break;
+			case UNSIGNED_LONG:
+				ss << get_value_at<unsigned long>(e);
+				break;
+			case LONG_LONG_INT:
+			case LONG_LONG:
+				ss << get_value_at<long long>(e);
+				break;
+			case UNSIGNED_LONG_LONG:
+				ss << get_value_at<unsigned long long>(e);
+				break;
+			case INTEGER8:
+			case INT64:
+				ss << get_value_at<int64_t>(e);
+				break;
+			case UINT64:
+				ss << get_value_at<uint64_t>(e);
+				break;
+			case FLOAT:
+			case REAL4:
+				ss << get_value_at<float>(e);
+				break;
+			case DOUBLE:
+			case REAL:
+			case DOUBLE_PRECISION:
+			case REAL8:
+				ss << get_value_at<double>(e);
+				break;
+			case LONG_DOUBLE:
+				ss << get_value_at<long double>(e);
+				break;
+			case BOOL:
+			case LOGICAL:
+				ss << (get_value_at<bool>(e) ? "true" : "false");
+				break;
+			case COMPLEX8:
+				ss << get_value_at<std::complex<float>>(e);
+				break;
+			case COMPLEX:
+			case COMPLEX16:
+				ss << get_value_at<std::complex<double>>(e);
+				break;
+			case STRING:
+			case WSTRING: {
+				ArraySpan<char> value = get_value_at<ArraySpan<char>>(e);
+				ss << string(value.data(), value.size());
+				break;
+			}
+			case INT16_ARRAY:
+			case INT32_ARRAY:
+			case INT64_ARRAY:
+			case UINT16_ARRAY:
+			case UINT32_ARRAY:
+			case UINT64_ARRAY:
+			case FLOAT_ARRAY:
+			case DOUBLE_ARRAY:
+				// Length is at the same place in the span whatever the element type
+				ss << "[" << get_value_at<ArraySpan<char>>(e).size() << " values]";
+				break;
+			case STRING_ARRAY:
+				ss << "[" << string_arrays[get_value_at<uint32_t>(e)].size() << " values]";
+				break;
+			case LOCAL_MATRIX: {
+				LocalMatrix_ptr value = local_matrices[get_value_at<uint32_t>(e)];
+				ss << value->Height() << " x " << value->Width();
+				break;
+			}
+			case ARRAY_INFO:
+				ss << matrix_infos[get_value_at<uint32_t>(e)]->to_string();
+				break;
+			case DISTMATRIX:
+				ss << distmatrices[get_value_at<uint32_t>(e)];
+				break;
+			case VOID_POINTER:
+				ss << get_value_at<void *>(e);
+				break;
+			default:
+				break;
 		}
 
-		return arg_list.str();
+		return ss.str();
 	}
-
-private:
-	std::map<string, std::shared_ptr<Parameter> > parameters;
 };
 
 }
@@ -139,10 +139,11 @@ bool Session::handle_handshake()
 			double * temp = new double[12];
 			for (auto i = 0; i < 12; i++) temp[i] = 1.11*(i+3);
 			DoubleArrayBlock_ptr block = read_msg.read_DoubleArrayBlock();
-			if (read_msg.compare_array_block(block, temp)) {
+			if (read_msg.compare_array_block(block, temp, 12)) {
 
 				log->info("{} Received handshake", preamble());
 				log->info("{} Client Language is {}", preamble(), get_client_language_name(cl));
+				handle_handshake_options();
 				return valid_handshake();
 			}
 		}
@@ -153,6 +154,53 @@ bool Session::handle_handshake()
 	return false;
 }
 
+bool Session::handle_handshake_options()
+{
+	accepted_options.clear();
+
+	while (!read_msg.eom()) {
+		handshake_option option = (handshake_option) read_msg.read_uint8();
+
+		switch (option) {
+			case OPTION_SHARED_MEMORY: {
+				string name = read_msg.read_string();
+				uint64_t length = read_msg.read_uint64();
+
+				if (!accepts_shared_memory()) {
+					log->info("{} Shared memory transport is not available for this session", preamble());
+					break;
+				}
+
+				SharedMemoryRegion_ptr region = std::make_shared<SharedMemoryRegion>();
+				if (region->open(name, length)) {
+					read_msg.shared_memory = region;
+					write_msg.shared_memory = region;
+					accepted_options.push_back(option);
+					log->info("{} Using shared memory region {} ({} bytes)", preamble(), name, length);
+				}
+				else log->info("{} Unable to map shared memory region {}", preamble(), name);
+				break;
+			}
+			case OPTION_LITTLE_ENDIAN:
+				accepted_options.push_back(option);
+				log->info("{} Using little-endian integers", preamble());
+				break;
+			case OPTION_ROW_LAYOUT:
+				read_msg.row_layout = true;
+				write_msg.row_layout = true;
+				accepted_options.push_back(option);
+				log->info("{} Sending the worker of every row with array info", preamble());
+				break;
+			default:
+				// Payload of an unknown option cannot be skipped, so ignore the remaining options
+				log->info("{} Ignoring unknown handshake option {}", preamble(), (uint16_t) option);
+				return false;
+		}
+	}
+
+	return true;
+}
+
 bool Session::valid_handshake()
 {
 	assign_sessionID();
@@ -162,9 +210,18 @@ bool Session::valid_handshake()
 	write_msg.write_uint16(4321);
 	write_msg.write_string(string("DCBA"));
 	write_msg.write_double(3.33);
+	for (handshake_option option : accepted_options)
+		write_msg.write_uint8(option);
 
 	flush();
 
+	// The handshake reply itself is still big-endian, everything after it is not
+	for (handshake_option option : accepted_options)
+		if (option == OPTION_LITTLE_ENDIAN) {
+			read_msg.little_endian = true;
+			write_msg.little_endian = true;
+		}
+
 	return true;
 }
 
@@ -194,13 +251,17 @@ void Session::read_header()
 	asio::async_read(socket,
 			asio::buffer(read_msg.header(), Message::header_length),
 				[this, self](error_code ec, std::size_t /*length*/) {
-			if (!ec) { read_msg.decode_header(); read_body(); }
+			if (!ec) {
+				read_msg.decode_header();
+				if (!stream_body()) read_body();
+			}
 			else remove_session();
 		});
 }
 
 void Session::read_body()
 {
+	read_msg.reserve(read_msg.body_length);
 	auto self(shared_from_this());
 	asio::async_read(socket,
 			asio::buffer(read_msg.body(), read_msg.body_length),
@@ -33,9 +33,12 @@ public:
 	bool get_admin_privilege() const;
 
 	bool handle_handshake();
+	bool handle_handshake_options();
 	bool valid_handshake();
 	bool invalid_handshake();
 
+	virtual bool accepts_shared_memory() const { return false; }
+
 	virtual bool send_response_string() = 0;
 	bool send_test_string();
 
@@ -47,6 +50,9 @@ public:
 	void read_body();
 	void flush();
 
+	// Lets a session consume the body of a message as it arrives instead of buffering all of it first
+	virtual bool stream_body() { return false; }
+
 	string preamble();
 	string client_preamble();
 	string session_preamble();
@@ -76,6 +82,8 @@ protected:
 
 	client_language cl;
 
+	vector<handshake_option> accepted_options;
+
 	tcp::socket socket;
 
 //	Message_queue write_msgs;
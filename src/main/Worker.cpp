@@ -9,6 +9,7 @@ Worker::Worker(io_context & _io_context, const unsigned int _port) :
 		ic(_io_context), group_worker(nullptr), ID(0), clientID(0), next_sessionID(0), accept_connections(false)
 {
 	world = MPI_COMM_WORLD;
+	MPI_Comm_dup(world, &control);
 
 	endpoint = tcp::endpoint(tcp::v4(), _port);
 
@@ -66,6 +67,7 @@ int Worker::wait_for_command()
 		MPI_Ibcast(&c, 1, MPI_UNSIGNED_CHAR, 0, world, &req);
 		while (flag == 0) {
 			MPI_Test(&req, &flag, &status);
+			if (flag == 0) check_new_group();
 			std::this_thread::sleep_for(std::chrono::milliseconds(200));
 		}
 
@@ -101,9 +103,6 @@ int Worker::handle_command(alchemist_command c)
 		case _AM_SEND_INFO:
 			send_info();
 			break;
-		case _AM_NEW_GROUP:
-			handle_new_group();
-			break;
 		case _AM_NEW_SESSION:
 //			new_session();
 			break;
@@ -149,51 +148,102 @@ void Worker::send_info()
 	MPI_Send(address.c_str(), al, MPI_CHAR, 0, 0, world);
 	MPI_Send(&port, 1, MPI_UNSIGNED_SHORT, 0, 0, world);
 
+	CPULocation location = get_cpu_location();
+	MPI_Send(&location.socket, 1, MPI_SHORT, 0, 0, world);
+	MPI_Send(&location.numa_node, 1, MPI_SHORT, 0, 0, world);
+
 	MPI_Barrier(world);
 }
 
-void Worker::handle_new_group()
+// Groups are formed by messages from the driver to just the workers in the group, see Driver::set_group_communicator
+void Worker::check_new_group()
 {
+	int pending = 0;
 	MPI_Status status;
 
-	GroupID groupID;
-
-	int primary_group_worker = -1;
+	MPI_Iprobe(0, NEW_GROUP_TAG, control, &pending, &status);
+	if (pending) {
+		int length;
+		MPI_Get_count(&status, MPI_INT, &length);
 
-	MPI_Recv(&groupID, 1, MPI_UNSIGNED_SHORT, 0, 0, world, &status);
-	if (groupID > 0) {
+		vector<int> description(length);
+		MPI_Recv(description.data(), length, MPI_INT, 0, NEW_GROUP_TAG, control, &status);
 
-		uint16_t num_peers = 0;
-
-		MPI_Recv(&num_peers, 1, MPI_UNSIGNED_SHORT, 0, 0, world, &status);
+		threads.push_back(std::thread(&Worker::handle_new_group, this, description));
+	}
+}
 
+void Worker::handle_new_group(vector<int> description)
+{
+	GroupID groupID = (GroupID) description[0];
+	group_comm_source comm_source = (group_comm_source) description[1];
+	group_role role = (group_role) description[2];
+	uint16_t num_peers = (uint16_t) description[3];
+	int * group_peerIDs = &description[4];
+	uint16_t num_previous_peers = (uint16_t) description[4+num_peers];
+	int * previous_peerIDs = &description[5+num_peers];
+
+	// Wait for the command loop of the previous group to finish before replacing its communicators
+	std::lock_guard<std::mutex> lock(group_mutex);
+
+	if (role != DEPARTING_GROUP_MEMBER) {
 		int groupIDs[(int) num_peers+1];
-		int group_peerIDs[(int) num_peers];
 
 		groupIDs[0] = 0;
-		MPI_Recv(&group_peerIDs, (int) num_peers, MPI_INT, 0, 0, world, &status);
-		MPI_Recv(&primary_group_worker, 1, MPI_INT, 0, 0, world, &status);
-
 		for (uint16_t i = 0; i < num_peers; i++) groupIDs[i+1] = group_peerIDs[i];
 
+		bool primary_group_worker = (role == PRIMARY_GROUP_MEMBER);
+
 		if (group_worker == nullptr)
-			group_worker = std::make_shared<GroupWorker>(groupID, *this, ic, port, primary_group_worker == 0, log);
+			group_worker = std::make_shared<GroupWorker>(groupID, *this, ic, port, primary_group_worker, log);
+		else group_worker->set_group(groupID, primary_group_worker);
+
+		vector<WorkerID> group_key(group_peerIDs, group_peerIDs + num_peers);
 
-		MPI_Group world_group;
+		if (comm_source == CACHED_GROUP_COMM) group_worker->reuse_group_comms(group_key);
+		else {
+			MPI_Group world_group;
+			MPI_Group temp_group;
+			MPI_Comm_group(world, &world_group);
+
+			MPI_Group_incl(world_group, (int) (num_peers+1), groupIDs, &temp_group);
+			group_worker->set_group_comm(world, temp_group);
+			MPI_Group_free(&temp_group);
+
+			MPI_Group_incl(world_group, (int) num_peers, group_peerIDs, &temp_group);
+			group_worker->set_group_peers_comm(world, temp_group);
+
+			MPI_Group_free(&world_group);
+			MPI_Group_free(&temp_group);
+
+			if (comm_source == NEW_CACHED_GROUP_COMM) group_worker->cache_group_comms(group_key);
+		}
+	}
+
+	// The group's matrices are moved from the workers it was formed with before to its new workers, see
+	// Driver::set_group_communicator
+	if (num_previous_peers > 0) {
+		vector<int> handoverIDs(1, 0);
+		std::set_union(previous_peerIDs, previous_peerIDs + num_previous_peers, group_peerIDs, group_peerIDs + num_peers,
+				std::back_inserter(handoverIDs));
+
+		MPI_Group control_group;
 		MPI_Group temp_group;
-		MPI_Comm_group(world, &world_group);
+		MPI_Comm handover;
 
-		MPI_Group_incl(world_group, (int) (num_peers+1), groupIDs, &temp_group);
-		group_worker->set_group_comm(world, temp_group);
+		MPI_Comm_group(control, &control_group);
+		MPI_Group_incl(control_group, (int) handoverIDs.size(), handoverIDs.data(), &temp_group);
+		MPI_Comm_create_group(control, temp_group, groupID, &handover);
 
-		MPI_Group_incl(world_group, (int) num_peers, group_peerIDs, &temp_group);
-		group_worker->set_group_peers_comm(world, temp_group);
+		bool previous_member = std::find(previous_peerIDs, previous_peerIDs + num_previous_peers, (int) ID) != previous_peerIDs + num_previous_peers;
+		group_worker->redistribute_matrices(handover, previous_member, role != DEPARTING_GROUP_MEMBER);
 
-		MPI_Group_free(&world_group);
+		MPI_Comm_free(&handover);
+		MPI_Group_free(&control_group);
 		MPI_Group_free(&temp_group);
-
-		group_worker->start();
 	}
+
+	if (role != DEPARTING_GROUP_MEMBER) group_worker->start();
 }
 
 void Worker::print_info()
@@ -47,6 +47,7 @@ public:
 
 private:
 	MPI_Comm world;
+	MPI_Comm control;					// For messages from the driver to this worker alone, such as new groups
 	MPI_Comm group;
 	MPI_Comm group_peers;
 
@@ -56,6 +57,7 @@ private:
 	uint16_t port;
 
 	GroupWorker_ptr group_worker;
+	std::mutex group_mutex;			// Held while the group worker is set up for and serving a group
 
 	WorkerID ID;
 	ClientID clientID;
@@ -80,7 +82,8 @@ private:
 
 	int start();
 	void send_info();
-	void handle_new_group();
+	void check_new_group();
+	void handle_new_group(vector<int> description);
 	void get_group_peers();
 
 //	string session_preamble();
@@ -55,10 +55,6 @@ int WorkerSession::handle_message()
 				send_response_string();
 				read_header();
 				break;
-			case SEND_MATRIX_BLOCKS:
-				receive_matrix_blocks();
-				read_header();
-				break;
 			case REQUEST_MATRIX_BLOCKS:
 				send_matrix_blocks();
 				read_header();
@@ -72,8 +68,6 @@ int WorkerSession::handle_message()
 bool WorkerSession::send_matrix_blocks()
 {
 	uint32_t num_blocks = 0;
-	uint64_t i, j;
-	double temp;
 	DoubleArrayBlock_ptr in_block, out_block;
 
 	ArrayID matrixID = read_msg.read_uint16();
@@ -87,16 +81,30 @@ bool WorkerSession::send_matrix_blocks()
 
 	while (!read_msg.eom()) {
 
-		in_block = read_msg.read_DoubleArrayBlock();
-		out_block = std::make_shared<ArrayBlock<double>>(*in_block);
+		bool shared = (read_msg.preview_datatype() == ARRAY_BLOCK_DOUBLE_SHARED);
 
-		write_msg.write_DoubleArrayBlock(out_block);
+		in_block = shared ? read_msg.read_SharedDoubleArrayBlock() : read_msg.read_DoubleArrayBlock();
 
-		for (i = in_block->dims[0][0]; i < in_block->dims[1][0]; i += in_block->dims[2][0])
-			for (j = in_block->dims[0][1]; j < in_block->dims[1][1]; j += in_block->dims[2][1]) {
-				group_worker.get_value(matrixID, i, j, temp);
-				out_block->write_next(&temp);
-			}
+		if (in_block != nullptr) {
+			out_block = std::make_shared<ArrayBlock<double>>(*in_block);
+			out_block->size = in_block->size;
+		}
+
+		if (in_block == nullptr || !group_worker.check_block(matrixID, out_block)) {
+			log->info("{} Error in WorkerSession: Invalid data block for array {}", session_preamble(), matrixID);
+			write_msg.write_error_code(ERR_INVALID_ARRAY_BLOCK);
+			break;
+		}
+
+		if (shared) {
+			// Block is filled in place in the shared memory region, the reply only references it
+			out_block->start = in_block->start;
+			write_msg.write_SharedDoubleArrayBlock(out_block);
+		}
+		else write_msg.write_DoubleArrayBlock(out_block);
+
+		group_worker.get_block(matrixID, out_block);
+		if (!shared) write_msg.finish_DoubleArrayBlock(out_block);
 
 		num_blocks++;
 	}
@@ -108,41 +116,134 @@ bool WorkerSession::send_matrix_blocks()
 	return true;
 }
 
-bool WorkerSession::receive_matrix_blocks()
+// Blocks sent to the worker are read one at a time: the header of each block goes into the (small) message buffer and
+// its data is read either directly into the local matrix or into a staging buffer the size of one block
+bool WorkerSession::stream_body()
 {
-	uint32_t num_blocks = 0;
-	uint64_t i, j;
-	double temp;
+	if (read_msg.cc != SEND_MATRIX_BLOCKS) return false;
 
-	ArrayID matrixID = read_msg.read_ArrayID();
+	if (sessionID != read_msg.sessionID) {
+		log->info("{} Error in WorkerSession: Wrong session ID", session_preamble());
+	}
 
-	log->info("{} Receiving data blocks for array {}", session_preamble(), matrixID);
+	stream_remaining = read_msg.body_length;
+	stream_num_blocks = 0;
+	stream_start = clock();
+	stream_error = ERR_NONE;
 
-	clock_t start = clock();
+	// Datatype followed by the array ID
+	read_stream(0, 3, [this]() {
+		stream_matrixID = read_msg.read_ArrayID();
+		log->info("{} Receiving data blocks for array {}", session_preamble(), stream_matrixID);
+		read_block_header();
+	});
 
-	while (!read_msg.eom()) {
+	return true;
+}
+
+void WorkerSession::read_stream(const uint32_t offset, const uint32_t length, std::function<void()> handler)
+{
+	if (length > stream_remaining) {
+		log->info("{} Error in WorkerSession: Array block extends past end of message", session_preamble());
+		remove_session();
+		return;
+	}
+
+	read_msg.reserve(offset + length);
+	read_msg.read_pos = Message::header_length;
 
-		DoubleArrayBlock_ptr block = read_msg.read_DoubleArrayBlock();
+	auto self(shared_from_this());
+	asio::async_read(socket,
+			asio::buffer(read_msg.body() + offset, length),
+				[this, self, length, handler](error_code ec, std::size_t /*length*/) {
+			if (!ec) {
+				stream_remaining -= length;
+				handler();
+			}
+			else remove_session();
+		});
+}
+
+void WorkerSession::read_block_header()
+{
+	if (stream_remaining == 0) {
+		finish_stream();
+		return;
+	}
 
-		for (i = block->dims[0][0]; i < block->dims[1][0]; i += block->dims[2][0])
-			for (j = block->dims[0][1]; j < block->dims[1][1]; j += block->dims[2][1]) {
-				block->read_next(&temp);
-				group_worker.set_value(matrixID, i, j, temp);
+	// Datatype and number of dimensions
+	read_stream(0, 2, [this]() {
+		datatype dt = read_msg.preview_datatype();
+		uint8_t ndims = (uint8_t) read_msg.body()[1];
+
+		// Block size and dimensions, plus the offset for blocks in shared memory
+		uint32_t length = 8 + 24*ndims;
+		if (dt == ARRAY_BLOCK_DOUBLE_SHARED) length += 8;
+
+		read_stream(2, length, [this, dt]() {
+			if (dt == ARRAY_BLOCK_DOUBLE_SHARED) {
+				DoubleArrayBlock_ptr block = read_msg.read_SharedDoubleArrayBlock();
+				if (block != nullptr && group_worker.set_block(stream_matrixID, block)) stream_num_blocks++;
+				else stream_error = ERR_INVALID_ARRAY_BLOCK;
+				read_block_header();
 			}
+			else {
+				read_msg.check_datatype(ARRAY_BLOCK_DOUBLE);
+				read_block_data(read_msg.get_DoubleArrayBlock_header());
+			}
+		});
+	});
+}
 
-		num_blocks++;
-//		log->info("{} Array {}: Received matrix block (rows {}-{}, columns {}-{})", session_preamble(), matrixID, row_start, row_end, col_start, col_end);
+void WorkerSession::read_block_data(DoubleArrayBlock_ptr block)
+{
+	if (block == nullptr || block->size > stream_remaining/8) {
+		log->info("{} Error in WorkerSession: Array block extends past end of message", session_preamble());
+		remove_session();
+		return;
 	}
 
+	uint64_t length = 8*block->size;
+
+	char * target = (char *) group_worker.get_block_target(stream_matrixID, block);
+	bool staged = (target == nullptr);
+	if (staged) {
+		if (staging.size() < length) staging.resize(length);
+		target = staging.data();
+	}
+	block->start = target;
+
+	auto self(shared_from_this());
+	asio::async_read(socket,
+			asio::buffer(target, length),
+				[this, self, block, length, staged](error_code ec, std::size_t /*length*/) {
+			if (!ec) {
+				stream_remaining -= (uint32_t) length;
+				if (read_msg.reverse_floats) reverse_bytes_64(block->start, block->size);
+				if (!staged || group_worker.set_block(stream_matrixID, block)) stream_num_blocks++;
+				else stream_error = ERR_INVALID_ARRAY_BLOCK;
+				read_block_header();
+			}
+			else remove_session();
+		});
+}
+
+void WorkerSession::finish_stream()
+{
 	write_msg.start(clientID, sessionID, SEND_MATRIX_BLOCKS);
-	write_msg.write_uint16(matrixID);
-	write_msg.write_uint32(num_blocks);
+	write_msg.write_uint16(stream_matrixID);
+	write_msg.write_uint32(stream_num_blocks);
+	if (stream_error != ERR_NONE) {
+		// The rest of the message is still consumed, so the session can carry on
+		log->info("{} Error in WorkerSession: Invalid data block for array {}", session_preamble(), stream_matrixID);
+		write_msg.write_error_code(stream_error);
+	}
 
 	clock_t end = clock();
-	log->info("{} Receiving data blocks took {}ms", session_preamble(), 1000.0*((double) (end - start))/((double) CLOCKS_PER_SEC));
+	log->info("{} Receiving data blocks took {}ms", session_preamble(), 1000.0*((double) (end - stream_start))/((double) CLOCKS_PER_SEC));
 	flush();
 
-	return true;
+	read_header();
 }
 
 bool WorkerSession::send_test_string()
@@ -25,7 +25,10 @@ public:
 	bool send_test_string();
 
 	bool send_matrix_blocks();
-	bool receive_matrix_blocks();
+
+	bool accepts_shared_memory() const { return true; }
+
+	bool stream_body();
 
 	// -------------------------------------   Matrix Management   -----------------------------------
 
@@ -43,6 +46,19 @@ private:
 
 	GroupWorker & group_worker;
 
+	// State of the SEND_MATRIX_BLOCKS message currently being streamed in
+	ArrayID stream_matrixID;
+	uint32_t stream_remaining;
+	uint32_t stream_num_blocks;
+	clock_t stream_start;
+	alchemist_error_code stream_error;
+	vector<char> staging;
+
+	void read_stream(const uint32_t offset, const uint32_t length, std::function<void()> handler);
+	void read_block_header();
+	void read_block_data(DoubleArrayBlock_ptr block);
+	void finish_stream();
+
 
 	// ---------------------------------------   Information   ---------------------------------------
 
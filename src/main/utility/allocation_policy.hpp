@@ -0,0 +1,36 @@
+#ifndef ALCHEMIST__ALLOCATION_POLICY_HPP
+#define ALCHEMIST__ALLOCATION_POLICY_HPP
+
+#include <string>
+#include <cstdlib>
+
+namespace alchemist {
+
+// How the driver picks workers for a group; clients can pass one as an optional hint after the number of workers
+// in REQUEST_WORKERS
+typedef enum _allocation_policy : uint8_t {
+	ALLOCATE_IN_ORDER = 0,				// Available workers with the lowest IDs
+	ALLOCATE_PACK_HOSTS,				// As few hosts as possible
+	ALLOCATE_SPREAD_HOSTS,				// As many hosts as possible
+	ALLOCATE_PACK_NUMA					// As few hosts as possible, and on each host as few NUMA nodes (or sockets) as possible
+} allocation_policy;
+
+inline const std::string get_allocation_policy_name(const allocation_policy & policy)
+{
+	switch (policy) {
+		case ALLOCATE_IN_ORDER:
+			return "IN ORDER";
+		case ALLOCATE_PACK_HOSTS:
+			return "PACK HOSTS";
+		case ALLOCATE_SPREAD_HOSTS:
+			return "SPREAD HOSTS";
+		case ALLOCATE_PACK_NUMA:
+			return "PACK NUMA";
+	}
+
+	return "UNKNOWN POLICY";
+}
+
+}			// namespace alchemist
+
+#endif
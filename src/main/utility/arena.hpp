@@ -0,0 +1,81 @@
+#ifndef ALCHEMIST__ARENA_HPP
+#define ALCHEMIST__ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace alchemist {
+
+// Bump allocator for short-lived data that is all released at once, such as the names and values of the parameters
+// of one task. Memory comes from a list of blocks; nothing is freed until clear() (which keeps the first block for
+// reuse) or destruction, and no destructors are run, so only trivially copyable data should be placed in it.
+
+class Arena
+{
+public:
+	Arena(size_t _block_size = 4096) : block_size(_block_size), block_used(0), block_capacity(0) { }
+
+	Arena(const Arena &) = delete;
+	Arena & operator=(const Arena &) = delete;
+
+	char * allocate(size_t num_bytes, size_t alignment = alignof(std::max_align_t))
+	{
+		size_t offset = (block_used + alignment - 1) & ~(alignment - 1);
+
+		if (blocks.empty() || offset + num_bytes > block_capacity) {
+			// Oversized requests get a block of their own
+			add_block(num_bytes + alignment > block_size ? num_bytes + alignment : block_size);
+			offset = (block_used + alignment - 1) & ~(alignment - 1);
+		}
+
+		char * p = blocks.back().data.get() + offset;
+		block_used = offset + num_bytes;
+
+		return p;
+	}
+
+	template <typename T>
+	T * copy(const T * x, size_t n)
+	{
+		if (n == 0) return nullptr;
+
+		T * p = reinterpret_cast<T *>(allocate(n*sizeof(T), alignof(T)));
+		memcpy(p, x, n*sizeof(T));
+
+		return p;
+	}
+
+	void clear()
+	{
+		if (blocks.size() > 1) blocks.resize(1);
+		block_used = 0;
+		block_capacity = blocks.empty() ? 0 : blocks.front().capacity;
+	}
+
+private:
+	size_t block_size;
+	size_t block_used;
+	size_t block_capacity;
+
+	struct Block {
+		std::unique_ptr<char[]> data;
+		size_t capacity;
+	};
+
+	std::vector<Block> blocks;
+
+	void add_block(size_t capacity)
+	{
+		// Blocks come from new[], so the start of each block is suitably aligned for any fundamental type
+		blocks.push_back(Block{std::unique_ptr<char[]>(new char[capacity]), capacity});
+		block_used = 0;
+		block_capacity = capacity;
+	}
+};
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__ARENA_HPP
@@ -0,0 +1,175 @@
+#ifndef ALCHEMIST__BYTE_SWAP_HPP
+#define ALCHEMIST__BYTE_SWAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #define ALCHEMIST_X86_KERNELS
+  #include <immintrin.h>
+#endif
+
+namespace alchemist {
+
+// In-place byte reversal of arrays of 2-, 4- and 8-byte values, used to convert array data between the client's
+// and the host's byte order. Data does not need to be aligned. On x86 an AVX2 or SSSE3 shuffle kernel is selected
+// at run time; everything else, and the tail of each array, goes through the scalar loop.
+
+typedef enum _byte_swap_kernel : uint8_t {
+	SCALAR_KERNEL = 0,
+	SSSE3_KERNEL,
+	AVX2_KERNEL
+} byte_swap_kernel;
+
+inline void reverse_bytes_scalar(char * data, const size_t n, const size_t width)
+{
+	uint16_t x16;
+	uint32_t x32;
+	uint64_t x64;
+
+	switch (width) {
+		case 2:
+			for (size_t i = 0; i < n; i++) {
+				memcpy(&x16, data + 2*i, 2);
+				x16 = __builtin_bswap16(x16);
+				memcpy(data + 2*i, &x16, 2);
+			}
+			break;
+		case 4:
+			for (size_t i = 0; i < n; i++) {
+				memcpy(&x32, data + 4*i, 4);
+				x32 = __builtin_bswap32(x32);
+				memcpy(data + 4*i, &x32, 4);
+			}
+			break;
+		case 8:
+			for (size_t i = 0; i < n; i++) {
+				memcpy(&x64, data + 8*i, 8);
+				x64 = __builtin_bswap64(x64);
+				memcpy(data + 8*i, &x64, 8);
+			}
+			break;
+	}
+}
+
+#ifdef ALCHEMIST_X86_KERNELS
+
+// Shuffle masks for 2-, 4- and 8-byte values; 32 bytes so that AVX2 can use the same mask in both lanes
+alignas(32) static const char byte_swap_masks[3][32] = {
+	{1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+	{3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+	{7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8}
+};
+
+// Both kernels return the number of bytes they converted, which is a multiple of 16 (SSSE3) or 32 (AVX2)
+
+__attribute__((target("ssse3")))
+inline size_t reverse_bytes_ssse3(char * data, const size_t num_bytes, const char * mask)
+{
+	const __m128i shuffle = _mm_load_si128((const __m128i *) mask);
+
+	size_t i = 0;
+	for ( ; i + 64 <= num_bytes; i += 64) {
+		__m128i x0 = _mm_loadu_si128((const __m128i *) (data + i));
+		__m128i x1 = _mm_loadu_si128((const __m128i *) (data + i + 16));
+		__m128i x2 = _mm_loadu_si128((const __m128i *) (data + i + 32));
+		__m128i x3 = _mm_loadu_si128((const __m128i *) (data + i + 48));
+		_mm_storeu_si128((__m128i *) (data + i), _mm_shuffle_epi8(x0, shuffle));
+		_mm_storeu_si128((__m128i *) (data + i + 16), _mm_shuffle_epi8(x1, shuffle));
+		_mm_storeu_si128((__m128i *) (data + i + 32), _mm_shuffle_epi8(x2, shuffle));
+		_mm_storeu_si128((__m128i *) (data + i + 48), _mm_shuffle_epi8(x3, shuffle));
+	}
+	for ( ; i + 16 <= num_bytes; i += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i *) (data + i));
+		_mm_storeu_si128((__m128i *) (data + i), _mm_shuffle_epi8(x, shuffle));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+inline size_t reverse_bytes_avx2(char * data, const size_t num_bytes, const char * mask)
+{
+	const __m256i shuffle = _mm256_load_si256((const __m256i *) mask);
+
+	size_t i = 0;
+	for ( ; i + 128 <= num_bytes; i += 128) {
+		__m256i x0 = _mm256_loadu_si256((const __m256i *) (data + i));
+		__m256i x1 = _mm256_loadu_si256((const __m256i *) (data + i + 32));
+		__m256i x2 = _mm256_loadu_si256((const __m256i *) (data + i + 64));
+		__m256i x3 = _mm256_loadu_si256((const __m256i *) (data + i + 96));
+		_mm256_storeu_si256((__m256i *) (data + i), _mm256_shuffle_epi8(x0, shuffle));
+		_mm256_storeu_si256((__m256i *) (data + i + 32), _mm256_shuffle_epi8(x1, shuffle));
+		_mm256_storeu_si256((__m256i *) (data + i + 64), _mm256_shuffle_epi8(x2, shuffle));
+		_mm256_storeu_si256((__m256i *) (data + i + 96), _mm256_shuffle_epi8(x3, shuffle));
+	}
+	for ( ; i + 32 <= num_bytes; i += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i *) (data + i));
+		_mm256_storeu_si256((__m256i *) (data + i), _mm256_shuffle_epi8(x, shuffle));
+	}
+
+	return i;
+}
+
+#endif
+
+inline byte_swap_kernel detect_byte_swap_kernel()
+{
+#ifdef ALCHEMIST_X86_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return AVX2_KERNEL;
+	if (__builtin_cpu_supports("ssse3")) return SSSE3_KERNEL;
+#endif
+	return SCALAR_KERNEL;
+}
+
+inline byte_swap_kernel get_byte_swap_kernel()
+{
+	static const byte_swap_kernel kernel = detect_byte_swap_kernel();
+	return kernel;
+}
+
+inline const std::string get_byte_swap_kernel_name(const byte_swap_kernel & kernel)
+{
+	switch (kernel) {
+		case AVX2_KERNEL:
+			return "AVX2";
+		case SSSE3_KERNEL:
+			return "SSSE3";
+		default:
+			return "SCALAR";
+	}
+}
+
+// Reverses the bytes of each of the n values of the given width (2, 4 or 8) starting at data
+inline void reverse_bytes(char * data, const size_t n, const size_t width)
+{
+	size_t num_bytes = n*width, done = 0;
+
+#ifdef ALCHEMIST_X86_KERNELS
+	const char * mask = byte_swap_masks[width == 2 ? 0 : (width == 4 ? 1 : 2)];
+
+	switch (get_byte_swap_kernel()) {
+		case AVX2_KERNEL:
+			done = reverse_bytes_avx2(data, num_bytes, mask);
+			break;
+		case SSSE3_KERNEL:
+			done = reverse_bytes_ssse3(data, num_bytes, mask);
+			break;
+		default:
+			break;
+	}
+#endif
+
+	reverse_bytes_scalar(data + done, (num_bytes - done)/width, width);
+}
+
+inline void reverse_bytes_16(char * data, const size_t n) { reverse_bytes(data, n, 2); }
+inline void reverse_bytes_32(char * data, const size_t n) { reverse_bytes(data, n, 4); }
+inline void reverse_bytes_64(char * data, const size_t n) { reverse_bytes(data, n, 8); }
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__BYTE_SWAP_HPP
@@ -0,0 +1,78 @@
+#ifndef ALCHEMIST__COLUMN_STATS_HPP
+#define ALCHEMIST__COLUMN_STATS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mpi.h>
+
+namespace alchemist {
+
+// Running summary of one column: count, mean and sum of squared deviations are kept with Welford's update, so that a
+// single pass is enough and variances do not suffer from cancellation. NaNs are counted and otherwise left out.
+// Summaries of different parts of a column are combined with Chan et al.'s formula, which is what the MPI reduction
+// operation below does for the parts held by different workers.
+struct ColumnStats {
+	double count;
+	double mean;
+	double m2;
+	double min;
+	double max;
+	double sum_abs;
+	double sum_squares;
+	double nan_count;
+
+	ColumnStats() : count(0), mean(0), m2(0), min(INFINITY), max(-INFINITY), sum_abs(0), sum_squares(0), nan_count(0) { }
+
+	void add(const double x)
+	{
+		if (std::isnan(x)) {
+			nan_count += 1;
+			return;
+		}
+
+		count += 1;
+		double delta = x - mean;
+		mean += delta/count;
+		m2 += delta*(x - mean);
+		min = std::min(min, x);
+		max = std::max(max, x);
+		sum_abs += std::fabs(x);
+		sum_squares += x*x;
+	}
+
+	void merge(const ColumnStats & other)
+	{
+		double n = count + other.count;
+
+		if (n > 0) {
+			double delta = other.mean - mean;
+			mean += delta*other.count/n;
+			m2 += other.m2 + delta*delta*count*other.count/n;
+		}
+
+		count = n;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+		sum_abs += other.sum_abs;
+		sum_squares += other.sum_squares;
+		nan_count += other.nan_count;
+	}
+
+	// Sample variance, as Spark's column summaries report it
+	double variance() const { return (count > 1) ? m2/(count - 1) : 0.0; }
+};
+
+static_assert(sizeof(ColumnStats) == 8*sizeof(double), "ColumnStats must be a plain array of doubles");
+
+inline void merge_column_stats(void * in, void * inout, int * length, MPI_Datatype * /*datatype*/)
+{
+	ColumnStats * a = (ColumnStats *) in;
+	ColumnStats * b = (ColumnStats *) inout;
+
+	for (int i = 0; i < *length; i++) b[i].merge(a[i]);
+}
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__COLUMN_STATS_HPP
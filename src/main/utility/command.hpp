@@ -32,8 +32,21 @@ typedef enum _client_command : uint8_t {
 	SEND_MATRIX_LAYOUT = 32,
 	SEND_MATRIX_BLOCKS = 33,
 	REQUEST_MATRIX_BLOCKS = 34,
+	LOAD_MATRIX_FILE = 35,
+	SAVE_MATRIX = 36,
+	SAVE_SNAPSHOT = 37,
+	LOAD_SNAPSHOT = 38,
 	// Tasks
 	RUN_TASK = 41,
+	// Built-in operations
+	MATRIX_TRANSPOSE = 51,
+	MATRIX_MULTIPLY = 52,
+	MATRIX_ROWS = 53,
+	MATRIX_DIMENSIONS = 54,
+	MATRIX_VIEW = 55,
+	MATRIX_EXPRESSION = 56,
+	MATRIX_STATS = 57,
+	GENERATE_MATRIX = 58,
 	// Shutting down
 	SHUTDOWN = 99
 } client_command;
@@ -53,7 +66,18 @@ typedef enum _alchemist_command : uint8_t {
 	_AM_CLIENT_MATRIX_LAYOUT,
 	_AM_PRINT_DATA,
 	_AM_WORKER_LOAD_LIBRARY,
-	_AM_WORKER_RUN_TASK
+	_AM_WORKER_RUN_TASK,
+	_AM_LOAD_MATRIX_FILE,
+	_AM_SAVE_MATRIX,
+	_AM_SAVE_SNAPSHOT,
+	_AM_LOAD_SNAPSHOT,
+	_AM_MATRIX_TRANSPOSE,
+	_AM_MATRIX_MULTIPLY,
+	_AM_MATRIX_ROWS,
+	_AM_MATRIX_VIEW,
+	_AM_MATRIX_EXPRESSION,
+	_AM_MATRIX_STATS,
+	_AM_GENERATE_MATRIX
 } alchemist_command;
 
 typedef enum _alchemist_error_code : uint8_t {
@@ -63,9 +87,44 @@ typedef enum _alchemist_error_code : uint8_t {
 	ERR_INVALID_SESSION_ID,
 	ERR_INCONSISTENT_DATATYPES,
 	ERR_NO_WORKERS,
-	ERR_NONPOS_WORKER_REQUEST
+	ERR_NONPOS_WORKER_REQUEST,
+	ERR_REQUEST_TIMEOUT,
+	ERR_QUOTA_EXCEEDED,
+	ERR_FILE_ACCESS,
+	ERR_INVALID_MATRIX,
+	ERR_DIMENSION_MISMATCH,
+	ERR_INVALID_EXPRESSION,
+	ERR_INVALID_ARGUMENT,
+	ERR_INVALID_ARRAY_BLOCK
 } alchemist_error_code;
 
+// Optional features a client can ask for at the end of its handshake; accepted options are echoed back
+typedef enum _handshake_option : uint8_t {
+	OPTION_NONE = 0,
+	OPTION_SHARED_MEMORY = 1,
+	OPTION_LITTLE_ENDIAN = 2,
+	OPTION_ROW_LAYOUT = 3
+} handshake_option;
+
+// How the members of a new group get their communicators: freshly created, freshly created and kept for when a group
+// with the same workers is formed again, or taken from that cache
+typedef enum _group_comm_source : uint8_t {
+	NEW_GROUP_COMM = 0,
+	NEW_CACHED_GROUP_COMM,
+	CACHED_GROUP_COMM
+} group_comm_source;
+
+// Part a worker plays when a group is formed: ordinary or primary member of the group, or a worker that has just left
+// it and only hands over its share of the group's matrices
+typedef enum _group_role : uint8_t {
+	GROUP_MEMBER = 0,
+	PRIMARY_GROUP_MEMBER,
+	DEPARTING_GROUP_MEMBER
+} group_role;
+
+// Tags of the messages sent from the driver to single workers over the control communicator
+enum { NEW_GROUP_TAG = 1 };
+
 inline const std::string get_command_name(const client_command & c)
 {
 	switch (c) {
@@ -111,8 +170,32 @@ inline const std::string get_command_name(const client_command & c)
 			return "SEND MATRIX BLOCKS";
 		case REQUEST_MATRIX_BLOCKS:
 			return "REQUEST MATRIX BLOCKS";
+		case LOAD_MATRIX_FILE:
+			return "LOAD MATRIX FILE";
+		case SAVE_MATRIX:
+			return "SAVE MATRIX";
+		case SAVE_SNAPSHOT:
+			return "SAVE SNAPSHOT";
+		case LOAD_SNAPSHOT:
+			return "LOAD SNAPSHOT";
 		case RUN_TASK:
 			return "RUN TASK";
+		case MATRIX_TRANSPOSE:
+			return "MATRIX TRANSPOSE";
+		case MATRIX_MULTIPLY:
+			return "MATRIX MULTIPLY";
+		case MATRIX_ROWS:
+			return "MATRIX ROWS";
+		case MATRIX_DIMENSIONS:
+			return "MATRIX DIMENSIONS";
+		case MATRIX_VIEW:
+			return "MATRIX VIEW";
+		case MATRIX_EXPRESSION:
+			return "MATRIX EXPRESSION";
+		case MATRIX_STATS:
+			return "MATRIX STATS";
+		case GENERATE_MATRIX:
+			return "GENERATE MATRIX";
 		case SHUTDOWN:
 			return "SHUTDOWN";
 		default:
@@ -151,6 +234,28 @@ inline const std::string get_command_name(const alchemist_command & c)
 			return "WORKER RUN TASK";
 		case _AM_PRINT_DATA:
 			return "PRINT DATA";
+		case _AM_LOAD_MATRIX_FILE:
+			return "LOAD MATRIX FILE";
+		case _AM_SAVE_MATRIX:
+			return "SAVE MATRIX";
+		case _AM_SAVE_SNAPSHOT:
+			return "SAVE SNAPSHOT";
+		case _AM_LOAD_SNAPSHOT:
+			return "LOAD SNAPSHOT";
+		case _AM_MATRIX_TRANSPOSE:
+			return "MATRIX TRANSPOSE";
+		case _AM_MATRIX_MULTIPLY:
+			return "MATRIX MULTIPLY";
+		case _AM_MATRIX_ROWS:
+			return "MATRIX ROWS";
+		case _AM_MATRIX_VIEW:
+			return "MATRIX VIEW";
+		case _AM_MATRIX_EXPRESSION:
+			return "MATRIX EXPRESSION";
+		case _AM_MATRIX_STATS:
+			return "MATRIX STATS";
+		case _AM_GENERATE_MATRIX:
+			return "GENERATE MATRIX";
 		default:
 			return "INVALID COMMAND";
 		}
@@ -173,6 +278,22 @@ inline const std::string get_error_name(const alchemist_error_code & ec)
 			return "ERR NO WORKERS";
 		case ERR_NONPOS_WORKER_REQUEST:
 			return "ERR NONPOSITIVE WORKER REQUEST";
+		case ERR_REQUEST_TIMEOUT:
+			return "ERR REQUEST TIMEOUT";
+		case ERR_QUOTA_EXCEEDED:
+			return "ERR QUOTA EXCEEDED";
+		case ERR_FILE_ACCESS:
+			return "ERR FILE ACCESS";
+		case ERR_INVALID_MATRIX:
+			return "ERR INVALID MATRIX";
+		case ERR_DIMENSION_MISMATCH:
+			return "ERR DIMENSION MISMATCH";
+		case ERR_INVALID_EXPRESSION:
+			return "ERR INVALID EXPRESSION";
+		case ERR_INVALID_ARGUMENT:
+			return "ERR INVALID ARGUMENT";
+		case ERR_INVALID_ARRAY_BLOCK:
+			return "ERR INVALID ARRAY BLOCK";
 		default:
 			return "INVALID COMMAND";
 		}
@@ -66,6 +66,17 @@ typedef enum _datatype : uint8_t {
 	ARRAY_BLOCK_DOUBLE,
 	DISTMATRIX,
 	VOID_POINTER,
+	ARRAY_BLOCK_DOUBLE_SHARED,
+	INT16_ARRAY,
+	INT32_ARRAY,
+	INT64_ARRAY,
+	UINT16_ARRAY,
+	UINT32_ARRAY,
+	UINT64_ARRAY,
+	FLOAT_ARRAY,
+	DOUBLE_ARRAY,
+	STRING_ARRAY,
+	LOCAL_MATRIX,
 	PARAMETER = 100
 } datatype;
 
@@ -208,6 +219,28 @@ inline const std::string get_datatype_name(const datatype & dt)
 			return "ARRAY BLOCK FLOAT";
 		case ARRAY_BLOCK_DOUBLE:
 			return "ARRAY BLOCK DOUBLE";
+		case ARRAY_BLOCK_DOUBLE_SHARED:
+			return "ARRAY BLOCK DOUBLE SHARED";
+		case INT16_ARRAY:
+			return "INT16 ARRAY";
+		case INT32_ARRAY:
+			return "INT32 ARRAY";
+		case INT64_ARRAY:
+			return "INT64 ARRAY";
+		case UINT16_ARRAY:
+			return "UINT16 ARRAY";
+		case UINT32_ARRAY:
+			return "UINT32 ARRAY";
+		case UINT64_ARRAY:
+			return "UINT64 ARRAY";
+		case FLOAT_ARRAY:
+			return "FLOAT ARRAY";
+		case DOUBLE_ARRAY:
+			return "DOUBLE ARRAY";
+		case STRING_ARRAY:
+			return "STRING ARRAY";
+		case LOCAL_MATRIX:
+			return "LOCAL MATRIX";
 		case DISTMATRIX:
 			return "DISTMATRIX";
 		case WORKER_INFO:
@@ -0,0 +1,269 @@
+#ifndef ALCHEMIST__EXPRESSION_HPP
+#define ALCHEMIST__EXPRESSION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace alchemist {
+
+// Elementwise expressions over matrices of the same shape, written in postfix (RPN) with tokens separated by spaces:
+//
+//   $k                                    k-th operand matrix
+//   1.5, -2, 1e-3, ...                    constants
+//   + - * / min max pow                   binary operations
+//   neg abs sqrt exp log log1p            unary operations
+//   clip                                  x lo hi clip = min(max(x, lo), hi)
+//   colsum colmean colmin colmax colstd   reduction over each column of the operand just before it, e.g. "$0 colmean"
+//
+// so "$0 $0 colmean - $0 colstd /" standardizes the columns of the first operand. Column reductions are computed
+// before the expression is evaluated; the expression itself is evaluated in a single pass over a chunk of rows of one
+// column at a time, each operation being a simple loop over the chunk that the compiler can vectorize.
+
+enum { EXPRESSION_CHUNK = 256 };
+
+typedef enum _expression_op : uint8_t {
+	PUSH_CONSTANT = 0,
+	PUSH_OPERAND,
+	PUSH_REDUCTION,
+	ADD,
+	SUBTRACT,
+	MULTIPLY,
+	DIVIDE,
+	MINIMUM,
+	MAXIMUM,
+	POWER,
+	NEGATE,
+	ABSOLUTE,
+	SQRT,
+	EXP,
+	LOG,
+	LOG1P,
+	CLIP
+} expression_op;
+
+typedef enum _column_reduction : uint8_t {
+	COLUMN_SUM = 0,
+	COLUMN_MEAN,
+	COLUMN_MIN,
+	COLUMN_MAX,
+	COLUMN_STD				// Population standard deviation
+} column_reduction;
+
+struct ExpressionInstruction {
+	expression_op op;
+	uint32_t index;			// Operand or reduction
+	double value;			// Constant
+};
+
+struct ColumnReduction {
+	uint32_t operand;
+	column_reduction reduction;
+};
+
+class Expression
+{
+public:
+	std::vector<ExpressionInstruction> program;
+	std::vector<ColumnReduction> reductions;
+	size_t max_depth;
+
+	Expression() : max_depth(0) { }
+
+	// Returns false, with a description of the problem in error, if the text is not a valid expression
+	bool compile(const std::string & text, const size_t num_operands, std::string & error)
+	{
+		program.clear();
+		reductions.clear();
+		max_depth = 0;
+
+		std::istringstream tokens(text);
+		std::string token;
+		size_t depth = 0;
+
+		while (tokens >> token) {
+			ExpressionInstruction instruction = {PUSH_CONSTANT, 0, 0.0};
+			size_t num_arguments = 0;
+
+			if (token[0] == '$') {
+				char * end;
+				long k = strtol(token.c_str() + 1, &end, 10);
+				if (*end != '\0' || token.size() == 1 || k < 0 || (size_t) k >= num_operands) {
+					error = "Invalid operand " + token;
+					return false;
+				}
+				instruction.op = PUSH_OPERAND;
+				instruction.index = (uint32_t) k;
+			}
+			else if (is_reduction(token)) {
+				if (program.empty() || program.back().op != PUSH_OPERAND) {
+					error = token + " has to follow an operand";
+					return false;
+				}
+				ColumnReduction r = {program.back().index, get_reduction(token)};
+				program.back().op = PUSH_REDUCTION;
+				program.back().index = (uint32_t) reductions.size();
+				reductions.push_back(r);
+				continue;
+			}
+			else if (get_op(token, instruction.op, num_arguments)) { }
+			else {
+				char * end;
+				instruction.value = strtod(token.c_str(), &end);
+				if (*end != '\0') {
+					error = "Unknown token " + token;
+					return false;
+				}
+			}
+
+			if (depth < num_arguments) {
+				error = "Not enough arguments for " + token;
+				return false;
+			}
+
+			depth = depth - num_arguments + 1;
+			max_depth = std::max(max_depth, depth);
+			program.push_back(instruction);
+		}
+
+		if (depth != 1) {
+			error = (depth == 0) ? "Empty expression" : "Expression leaves more than one value";
+			return false;
+		}
+
+		return true;
+	}
+
+	// Evaluates the expression for n consecutive rows of one column. operands[k] points at the first of those rows of
+	// the k-th operand, and the value of the r-th reduction for the column is reduction_values[r*reduction_stride].
+	// stack needs room for max_depth*EXPRESSION_CHUNK values; n must not be more than EXPRESSION_CHUNK.
+	void evaluate(const double * const * operands, const double * reduction_values, const size_t reduction_stride,
+			double * result, const size_t n, double * stack) const
+	{
+		double * top = stack - EXPRESSION_CHUNK;			// Topmost value on the stack
+
+		for (const ExpressionInstruction & instruction : program) {
+			double * x = top;
+			double * y = top - EXPRESSION_CHUNK;
+			double * z = top - 2*EXPRESSION_CHUNK;
+
+			switch (instruction.op) {
+				case PUSH_CONSTANT:
+					top += EXPRESSION_CHUNK;
+					std::fill(top, top + n, instruction.value);
+					break;
+				case PUSH_OPERAND:
+					top += EXPRESSION_CHUNK;
+					std::copy(operands[instruction.index], operands[instruction.index] + n, top);
+					break;
+				case PUSH_REDUCTION:
+					top += EXPRESSION_CHUNK;
+					std::fill(top, top + n, reduction_values[instruction.index*reduction_stride]);
+					break;
+				case ADD:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] += x[i];
+					top = y;
+					break;
+				case SUBTRACT:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] -= x[i];
+					top = y;
+					break;
+				case MULTIPLY:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] *= x[i];
+					top = y;
+					break;
+				case DIVIDE:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] /= x[i];
+					top = y;
+					break;
+				case MINIMUM:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] = std::min(y[i], x[i]);
+					top = y;
+					break;
+				case MAXIMUM:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) y[i] = std::max(y[i], x[i]);
+					top = y;
+					break;
+				case POWER:
+					for (size_t i = 0; i < n; i++) y[i] = std::pow(y[i], x[i]);
+					top = y;
+					break;
+				case NEGATE:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) x[i] = -x[i];
+					break;
+				case ABSOLUTE:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) x[i] = std::fabs(x[i]);
+					break;
+				case SQRT:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) x[i] = std::sqrt(x[i]);
+					break;
+				case EXP:
+					for (size_t i = 0; i < n; i++) x[i] = std::exp(x[i]);
+					break;
+				case LOG:
+					for (size_t i = 0; i < n; i++) x[i] = std::log(x[i]);
+					break;
+				case LOG1P:
+					for (size_t i = 0; i < n; i++) x[i] = std::log1p(x[i]);
+					break;
+				case CLIP:
+					#pragma omp simd
+					for (size_t i = 0; i < n; i++) z[i] = std::min(std::max(z[i], y[i]), x[i]);
+					top = z;
+					break;
+			}
+		}
+
+		std::copy(top, top + n, result);
+	}
+
+private:
+	static bool is_reduction(const std::string & token)
+	{
+		return token == "colsum" || token == "colmean" || token == "colmin" || token == "colmax" || token == "colstd";
+	}
+
+	static column_reduction get_reduction(const std::string & token)
+	{
+		if (token == "colsum") return COLUMN_SUM;
+		if (token == "colmean") return COLUMN_MEAN;
+		if (token == "colmin") return COLUMN_MIN;
+		if (token == "colmax") return COLUMN_MAX;
+		return COLUMN_STD;
+	}
+
+	static bool get_op(const std::string & token, expression_op & op, size_t & num_arguments)
+	{
+		static const struct { const char * name; expression_op op; size_t num_arguments; } ops[] = {
+			{"+", ADD, 2}, {"-", SUBTRACT, 2}, {"*", MULTIPLY, 2}, {"/", DIVIDE, 2}, {"min", MINIMUM, 2},
+			{"max", MAXIMUM, 2}, {"pow", POWER, 2}, {"neg", NEGATE, 1}, {"abs", ABSOLUTE, 1}, {"sqrt", SQRT, 1},
+			{"exp", EXP, 1}, {"log", LOG, 1}, {"log1p", LOG1P, 1}, {"clip", CLIP, 3}
+		};
+
+		for (const auto & o : ops)
+			if (token == o.name) {
+				op = o.op;
+				num_arguments = o.num_arguments;
+				return true;
+			}
+
+		return false;
+	}
+};
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__EXPRESSION_HPP
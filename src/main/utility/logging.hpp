@@ -71,7 +71,7 @@ inline Log_ptr start_log(std::string name, std::string pattern, std::string form
 	console_sink->set_pattern(pattern);
 	console_sink->set_color(spdlog::level::info, format + fore_color + back_color);
 
-	auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_st>(logfile_name, true);
+	auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logfile_name, true);
 	file_sink->set_level(spdlog::level::trace);
 
 	Log_ptr log;
@@ -0,0 +1,73 @@
+#ifndef ALCHEMIST__MATRIX_FILE_HPP
+#define ALCHEMIST__MATRIX_FILE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace alchemist {
+
+// Alchemist's own format for saved matrices: a 64-byte header followed by the matrix in row-major order, as doubles in
+// native byte order (recorded in the header for other tools). Since rows are contiguous, the rows of a [VR,STAR] matrix
+// held by one worker form a regular strided pattern in the file that can be written or read with collective MPI-IO
+// calls.
+
+enum { MATRIX_FILE_VERSION = 1, MATRIX_FILE_CHUNK_BYTES = 64 << 20 };
+
+// Formats LOAD_MATRIX_FILE can read. Raw files are rows of little-endian doubles with nothing else in the file, so
+// the number of columns has to be given; text files have one row per line.
+typedef enum _matrix_file_format : uint8_t {
+	AUTO_FORMAT = 0,
+	NATIVE_FORMAT,
+	HDF5_FORMAT,
+	TEXT_FORMAT,
+	RAW_FORMAT
+} matrix_file_format;
+
+// Format of a file that is not in Alchemist's own format, going by its extension
+inline matrix_file_format get_matrix_file_format(const std::string & file_name)
+{
+	size_t dot = file_name.find_last_of('.');
+	std::string extension = (dot == std::string::npos) ? "" : file_name.substr(dot + 1);
+
+	if (extension == "csv" || extension == "tsv" || extension == "txt") return TEXT_FORMAT;
+	if (extension == "bin" || extension == "raw") return RAW_FORMAT;
+
+	return HDF5_FORMAT;
+}
+
+struct MatrixFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_length;
+	uint64_t num_rows;
+	uint64_t num_cols;
+	uint8_t little_endian;
+	uint8_t reserved[31];
+
+	MatrixFileHeader() { memset(this, 0, sizeof(MatrixFileHeader)); }
+
+	MatrixFileHeader(const uint64_t _num_rows, const uint64_t _num_cols) : MatrixFileHeader()
+	{
+		memcpy(magic, "ALCHMTRX", 8);
+		version = MATRIX_FILE_VERSION;
+		header_length = sizeof(MatrixFileHeader);
+		num_rows = _num_rows;
+		num_cols = _num_cols;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		little_endian = 1;
+#endif
+	}
+
+	// The header is in native byte order too, so files written on a host with the other byte order are not valid
+	bool valid() const
+	{
+		return memcmp(magic, "ALCHMTRX", 8) == 0 && version == MATRIX_FILE_VERSION && header_length == sizeof(MatrixFileHeader);
+	}
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "Matrix file header must be 64 bytes");
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__MATRIX_FILE_HPP
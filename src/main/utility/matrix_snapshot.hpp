@@ -0,0 +1,109 @@
+#ifndef ALCHEMIST__MATRIX_SNAPSHOT_HPP
+#define ALCHEMIST__MATRIX_SNAPSHOT_HPP
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace alchemist {
+
+// Snapshot of a distributed matrix: one file per worker, "<path>.<rank>", holding a copy of the worker's local
+// Elemental buffer (column-major, leading dimension equal to the local height, native byte order) after a header that
+// describes the grid and distribution it belongs to. The data starts on a page boundary, so a group with the same grid
+// can map the file and attach its matrix to the mapping instead of reading it.
+
+enum { MATRIX_SNAPSHOT_VERSION = 1, MATRIX_SNAPSHOT_DATA_OFFSET = 4096 };
+
+struct MatrixSnapshotHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t data_offset;
+	uint64_t num_rows;
+	uint64_t num_cols;
+	uint64_t num_local_rows;
+	uint64_t num_local_cols;
+	uint32_t grid_size;
+	uint32_t grid_height;
+	uint32_t grid_rank;				// Rank of the worker in the grid's VR ordering
+	uint8_t col_dist;
+	uint8_t row_dist;
+	uint8_t dt;						// Always DOUBLE for now
+	uint8_t little_endian;
+	uint32_t col_align;
+	uint32_t row_align;
+	uint8_t reserved[56];
+
+	MatrixSnapshotHeader() { memset(this, 0, sizeof(MatrixSnapshotHeader)); }
+
+	bool valid() const
+	{
+		return memcmp(magic, "ALCHSNAP", 8) == 0 && version == MATRIX_SNAPSHOT_VERSION && data_offset == MATRIX_SNAPSHOT_DATA_OFFSET;
+	}
+
+	uint64_t data_length() const { return 8*num_local_rows*num_local_cols; }
+};
+
+static_assert(sizeof(MatrixSnapshotHeader) == 128, "Matrix snapshot header must be 128 bytes");
+
+inline std::string get_snapshot_file_name(const std::string & path, const int rank)
+{
+	return path + "." + std::to_string(rank);
+}
+
+// Private (copy-on-write) mapping of a snapshot file; changes made to a matrix attached to it never reach the file
+struct MappedSnapshot {
+	MappedSnapshot() : length(0), start(nullptr) { }
+
+	~MappedSnapshot() { close(); }
+
+	MatrixSnapshotHeader header;
+
+	uint64_t length;
+	char * start;
+
+	bool open(const std::string & file_name)
+	{
+		close();
+
+		int fd = ::open(file_name.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat sb;
+		if (fstat(fd, &sb) != 0 || (uint64_t) sb.st_size < MATRIX_SNAPSHOT_DATA_OFFSET ||
+				pread(fd, &header, sizeof(MatrixSnapshotHeader), 0) != (ssize_t) sizeof(MatrixSnapshotHeader) ||
+				!header.valid() || (uint64_t) sb.st_size < MATRIX_SNAPSHOT_DATA_OFFSET + header.data_length()) {
+			::close(fd);
+			return false;
+		}
+
+		void * addr = mmap(nullptr, (size_t) sb.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (addr == MAP_FAILED) return false;
+
+		length = (uint64_t) sb.st_size;
+		start = (char *) addr;
+
+		return true;
+	}
+
+	void close()
+	{
+		if (start != nullptr) munmap(start, (size_t) length);
+
+		length = 0;
+		start = nullptr;
+	}
+
+	double * data() const { return (double *) (start + header.data_offset); }
+};
+
+typedef std::shared_ptr<MappedSnapshot> MappedSnapshot_ptr;
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__MATRIX_SNAPSHOT_HPP
@@ -0,0 +1,160 @@
+#ifndef ALCHEMIST__RANDOM_MATRIX_HPP
+#define ALCHEMIST__RANDOM_MATRIX_HPP
+
+#include <cmath>
+#include <cstdint>
+
+namespace alchemist {
+
+// Random matrices generated on the workers. Every entry comes from the Philox4x32-10 counter-based generator (Salmon et
+// al., "Parallel random numbers: as easy as 1, 2, 3") keyed with the seed and with the entry's global row and column as
+// the counter, so a matrix depends only on its shape, distribution, parameters and seed, and not on how many workers
+// generate it or how its rows are spread over them.
+//
+//   GAUSSIAN      normal entries with mean a and standard deviation b (defaults 0 and 1)
+//   UNIFORM       entries uniform on [a, b) (defaults 0 and 1)
+//   SPARSE_SIGN   entries +1/sqrt(a) and -1/sqrt(a) with probability a/2 each and 0 otherwise (default a = 1/3)
+//   SRHT          subsampled randomized Hadamard transform for sketching the columns: entry (i, j) is
+//                 d_j*H(s_i, j)/sqrt(num_rows), with H the +-1 Walsh-Hadamard matrix of the next power of two at least
+//                 num_cols, d_j random signs and s_i rows of H sampled uniformly (with replacement)
+
+typedef enum _random_distribution : uint8_t {
+	GAUSSIAN_DISTRIBUTION = 0,
+	UNIFORM_DISTRIBUTION,
+	SPARSE_SIGN_DISTRIBUTION,
+	SRHT_DISTRIBUTION
+} random_distribution;
+
+inline const char * get_random_distribution_name(const random_distribution dist)
+{
+	switch (dist) {
+		case GAUSSIAN_DISTRIBUTION:
+			return "gaussian";
+		case UNIFORM_DISTRIBUTION:
+			return "uniform";
+		case SPARSE_SIGN_DISTRIBUTION:
+			return "sparse_sign";
+		case SRHT_DISTRIBUTION:
+			return "srht";
+		default:
+			return "unknown";
+	}
+}
+
+struct Philox4x32 {
+	uint32_t v[4];
+
+	Philox4x32(const uint32_t c0, const uint32_t c1, const uint32_t c2, const uint32_t c3, uint64_t seed)
+	{
+		uint32_t k0 = (uint32_t) seed, k1 = (uint32_t) (seed >> 32);
+
+		v[0] = c0;
+		v[1] = c1;
+		v[2] = c2;
+		v[3] = c3;
+
+		for (int r = 0; r < 10; r++) {
+			if (r > 0) {
+				k0 += 0x9E3779B9;
+				k1 += 0xBB67AE85;
+			}
+
+			uint64_t p0 = (uint64_t) 0xD2511F53*v[0];
+			uint64_t p1 = (uint64_t) 0xCD9E8D57*v[2];
+
+			uint32_t x0 = (uint32_t) (p1 >> 32) ^ v[1] ^ k0;
+			uint32_t x2 = (uint32_t) (p0 >> 32) ^ v[3] ^ k1;
+
+			v[0] = x0;
+			v[1] = (uint32_t) p1;
+			v[2] = x2;
+			v[3] = (uint32_t) p0;
+		}
+	}
+
+	// Uniform on (0, 1) with 53 random bits, from the first (k = 0) or last (k = 1) two words
+	double uniform(const int k) const
+	{
+		uint64_t bits = ((uint64_t) v[2*k] << 32) | v[2*k+1];
+		return ((double) (bits >> 11) + 0.5)*(1.0/9007199254740992.0);
+	}
+};
+
+class RandomMatrixGenerator
+{
+public:
+	RandomMatrixGenerator(const random_distribution _dist, const uint64_t _seed, const double _a, const double _b,
+			const uint64_t num_rows, const uint64_t num_cols) : dist(_dist), seed(_seed), a(_a), b(_b), hadamard_size(1)
+	{
+		while (hadamard_size < num_cols) hadamard_size <<= 1;
+
+		if (dist == SPARSE_SIGN_DISTRIBUTION) scale = 1.0/std::sqrt(a);
+		else if (dist == SRHT_DISTRIBUTION) scale = 1.0/std::sqrt((double) num_rows);
+		else scale = 1.0;
+	}
+
+	// Whether a and b make sense for the distribution
+	bool valid() const
+	{
+		switch (dist) {
+			case GAUSSIAN_DISTRIBUTION:
+				return b >= 0.0;
+			case UNIFORM_DISTRIBUTION:
+				return a < b;
+			case SPARSE_SIGN_DISTRIBUTION:
+				return a > 0.0 && a <= 1.0;
+			case SRHT_DISTRIBUTION:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	// Fills column j of the n rows whose global indices are in rows
+	void fill(const uint64_t j, const int64_t * rows, const size_t n, double * column) const
+	{
+		switch (dist) {
+			case GAUSSIAN_DISTRIBUTION:
+				for (size_t k = 0; k < n; k++) {
+					Philox4x32 r = get_entry_bits((uint64_t) rows[k], j);
+					column[k] = a + b*std::sqrt(-2.0*std::log(r.uniform(0)))*std::cos(2.0*M_PI*r.uniform(1));
+				}
+				break;
+			case UNIFORM_DISTRIBUTION:
+				for (size_t k = 0; k < n; k++) column[k] = a + (b - a)*get_entry_bits((uint64_t) rows[k], j).uniform(0);
+				break;
+			case SPARSE_SIGN_DISTRIBUTION:
+				for (size_t k = 0; k < n; k++) {
+					double u = get_entry_bits((uint64_t) rows[k], j).uniform(0);
+					column[k] = (u < 0.5*a) ? scale : ((u < a) ? -scale : 0.0);
+				}
+				break;
+			case SRHT_DISTRIBUTION: {
+				// The column sign uses a counter no entry can have, since entries never reach row 2^64-1
+				double d = (get_entry_bits(UINT64_MAX, j).v[0] & 1) ? -scale : scale;
+				for (size_t k = 0; k < n; k++) {
+					Philox4x32 r = get_entry_bits((uint64_t) rows[k], 0);
+					uint64_t s = (((uint64_t) r.v[0] << 32) | r.v[1]) & (hadamard_size - 1);
+					column[k] = (__builtin_popcountll(s & j) & 1) ? -d : d;
+				}
+				break;
+			}
+		}
+	}
+
+private:
+	random_distribution dist;
+	uint64_t seed;
+	double a, b;
+	double scale;
+	uint64_t hadamard_size;
+
+	Philox4x32 get_entry_bits(const uint64_t i, const uint64_t j) const
+	{
+		return Philox4x32((uint32_t) i, (uint32_t) (i >> 32), (uint32_t) j, (uint32_t) (j >> 32), seed);
+	}
+};
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__RANDOM_MATRIX_HPP
@@ -0,0 +1,87 @@
+#ifndef ALCHEMIST__SHARED_MEMORY_HPP
+#define ALCHEMIST__SHARED_MEMORY_HPP
+
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace alchemist {
+
+// Memory region shared with a client running on the same host. The client creates the region as a POSIX shared
+// memory object (e.g. "/alchemist-1234") and passes its name and length during the handshake. Only names of shared
+// memory objects are accepted, never paths, since the region is mapped for writing. Array blocks placed in the region are in native byte
+// order and are referenced from messages by their offset into the region.
+struct SharedMemoryRegion {
+	SharedMemoryRegion() : name(""), length(0), start(nullptr) { }
+
+	~SharedMemoryRegion() { close(); }
+
+	std::string name;
+	uint64_t length;
+
+	char * start;
+
+	bool open(const std::string & _name, const uint64_t _length)
+	{
+		close();
+
+		if (!valid_name(_name) || _length == 0) return false;
+
+		int fd = shm_open(_name.c_str(), O_RDWR, 0);
+		if (fd < 0) return false;
+
+		struct stat sb;
+		if (fstat(fd, &sb) != 0 || (uint64_t) sb.st_size < _length) {
+			::close(fd);
+			return false;
+		}
+
+		void * addr = mmap(nullptr, (size_t) _length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (addr == MAP_FAILED) return false;
+
+		name = _name;
+		length = _length;
+		start = (char *) addr;
+
+		return true;
+	}
+
+	void close()
+	{
+		if (start != nullptr) munmap(start, (size_t) length);
+
+		name = "";
+		length = 0;
+		start = nullptr;
+	}
+
+	bool is_open() const { return start != nullptr; }
+
+	// Names of shared memory objects: an optional leading slash, then a name without any further slashes
+	static bool valid_name(const std::string & name)
+	{
+		std::string base = (!name.empty() && name[0] == '/') ? name.substr(1) : name;
+
+		return !base.empty() && base != "." && base != ".." && base.find('/') == std::string::npos;
+	}
+
+	bool contains(const uint64_t offset, const uint64_t num_bytes) const
+	{
+		return start != nullptr && offset <= length && num_bytes <= length - offset;
+	}
+
+	char * at(const uint64_t offset) const { return start + offset; }
+
+	uint64_t offset_of(const char * ptr) const { return (uint64_t) (ptr - start); }
+};
+
+typedef std::shared_ptr<SharedMemoryRegion> SharedMemoryRegion_ptr;
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__SHARED_MEMORY_HPP
@@ -0,0 +1,143 @@
+#ifndef ALCHEMIST__TEXT_PARSER_HPP
+#define ALCHEMIST__TEXT_PARSER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace alchemist {
+
+// Parsing of delimited text (CSV and the like) into doubles. Fields are separated by commas, semicolons, tabs or
+// spaces. Numbers with at most 19 significant digits and a decimal exponent of at most 22 are converted exactly with
+// a single multiplication or division (Clinger's fast path), which covers what upstream jobs normally write; anything
+// else, including "nan" and "inf", goes through strtod.
+
+static const double exact_powers_of_ten[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool parse_double_slow(const char * & p, const char * end, double & x)
+{
+	char buffer[64];
+	size_t length = (size_t) (end - p) < sizeof(buffer) - 1 ? (size_t) (end - p) : sizeof(buffer) - 1;
+
+	memcpy(buffer, p, length);
+	buffer[length] = '\0';
+
+	char * parsed;
+	x = strtod(buffer, &parsed);
+	if (parsed == buffer) return false;
+
+	p += parsed - buffer;
+
+	return true;
+}
+
+// Parses the number starting at p, leaving p just past it
+inline bool parse_double(const char * & p, const char * end, double & x)
+{
+	const char * start = p;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+	uint64_t mantissa = 0;
+	int num_digits = 0, exponent = 0;
+	bool exact = true;
+	const char * digits = p;
+
+	for ( ; p < end && *p >= '0' && *p <= '9'; p++) {
+		if (num_digits < 19) {
+			mantissa = 10*mantissa + (uint64_t) (*p - '0');
+			if (mantissa > 0) num_digits++;
+		}
+		else {
+			exponent++;
+			if (*p != '0') exact = false;
+		}
+	}
+
+	bool has_digits = (p > digits);
+
+	if (p < end && *p == '.') {
+		for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+			has_digits = true;
+			if (num_digits < 19) {
+				mantissa = 10*mantissa + (uint64_t) (*p - '0');
+				if (mantissa > 0) num_digits++;
+				exponent--;
+			}
+			else if (*p != '0') exact = false;
+		}
+	}
+
+	if (!has_digits) {
+		p = start;
+		return parse_double_slow(p, end, x);
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char * e = p + 1;
+		bool negative_exponent = false;
+		int explicit_exponent = 0;
+
+		if (e < end && (*e == '-' || *e == '+')) negative_exponent = (*e++ == '-');
+		if (e < end && *e >= '0' && *e <= '9') {
+			for ( ; e < end && *e >= '0' && *e <= '9'; e++)
+				if (explicit_exponent < 10000) explicit_exponent = 10*explicit_exponent + (*e - '0');
+			exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+			p = e;
+		}
+	}
+
+	if (!exact || mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) {
+		p = start;
+		return parse_double_slow(p, end, x);
+	}
+
+	x = (double) mantissa;
+	x = (exponent < 0) ? x/exact_powers_of_ten[-exponent] : x*exact_powers_of_ten[exponent];
+	if (negative) x = -x;
+
+	return true;
+}
+
+inline bool is_field_space(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parses one line into row, storing at most num_cols values; returns the number of fields on the line, or -1 if one of
+// them is not a number
+inline int64_t parse_row(const char * p, const char * end, double * row, const uint64_t num_cols)
+{
+	int64_t num_fields = 0;
+	double x;
+
+	while (true) {
+		while (p < end && is_field_space(*p)) p++;
+		if (p == end) break;
+
+		if (!parse_double(p, end, x)) return -1;
+		if ((uint64_t) num_fields < num_cols) row[num_fields] = x;
+		num_fields++;
+
+		while (p < end && is_field_space(*p)) p++;
+		if (p < end && (*p == ',' || *p == ';')) p++;
+	}
+
+	return num_fields;
+}
+
+// Whether a line has nothing but white space on it
+inline bool is_blank_line(const char * p, const char * end)
+{
+	while (p < end && is_field_space(*p)) p++;
+
+	return p == end;
+}
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__TEXT_PARSER_HPP
@@ -0,0 +1,60 @@
+#ifndef ALCHEMIST__TOPOLOGY_HPP
+#define ALCHEMIST__TOPOLOGY_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+  #include <sched.h>
+  #include <dirent.h>
+#endif
+
+namespace alchemist {
+
+// Socket and NUMA node of the CPU the calling process is running on, as reported by sysfs (the same information
+// hwloc uses). Either is -1 where it is not known, e.g. on other platforms. Since MPI ranks are normally bound to
+// their cores, this is where the worker stays.
+
+struct CPULocation {
+	int16_t socket;
+	int16_t numa_node;
+};
+
+inline CPULocation get_cpu_location()
+{
+	CPULocation location = {-1, -1};
+
+#ifdef __linux__
+	int cpu = sched_getcpu();
+	if (cpu < 0) return location;
+
+	std::string cpu_path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+
+	int socket;
+	std::ifstream package_file(cpu_path + "/topology/physical_package_id");
+	if (package_file >> socket) location.socket = (int16_t) socket;
+
+	// The CPU's directory has a link named after its NUMA node
+	DIR * cpu_dir = opendir(cpu_path.c_str());
+	if (cpu_dir != nullptr) {
+		struct dirent * entry;
+		while ((entry = readdir(cpu_dir)) != nullptr) {
+			if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4])) {
+				location.numa_node = (int16_t) atoi(entry->d_name + 4);
+				break;
+			}
+		}
+		closedir(cpu_dir);
+	}
+#endif
+
+	return location;
+}
+
+}			// namespace alchemist
+
+#endif		// ALCHEMIST__TOPOLOGY_HPP